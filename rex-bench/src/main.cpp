@@ -0,0 +1,437 @@
+#include <rex-core/api.h>
+#include <rex-core/memory.h>
+#include <rex-core/path.h>
+#include <rex-core/str.h>
+#include <rex-core/thread.h>
+#include <rex-core/time.h>
+#include <rex-core/log.h>
+
+#include <rex-math/math.h>
+#include <rex-raster/rex.h>
+#include <rex-raster/raster.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// renders fixed scenes from a fixed camera without a window and reports the frame time of each stage as
+// json, e.g. rex-bench --frames 200 --output bench.json, the quad scenes compare the texture layouts with
+// rex-bench --scene quad and the layers scenes compare forward and visibility rendering with --scene layers
+
+using namespace rex;
+using namespace rex::raster;
+
+struct Options
+{
+	int width, height;
+	int warmup, frames;
+	// substring of the scene names to run, null runs all of them
+	const char* filter;
+	// json file path, null writes to stdout
+	const char* output;
+};
+
+struct Scene
+{
+	const char* name;
+	Mesh (*load)(rc::Thread_Pool* workers);
+	// replaces the default texture while the scene runs, null keeps it
+	Texture (*texture)();
+	// SHADER_FLAG bits the scene renders with
+	rc::u32 shader;
+};
+
+struct Result
+{
+	const char* name;
+	rc::sz triangles;
+	double frame_ms;
+	double vertex_ms, setup_ms, raster_ms, blit_ms;
+	Raster_Stats stats;
+};
+
+inline static Mesh
+_scene_cube(rc::Thread_Pool*)
+{
+	return mesh_cube();
+}
+
+inline static Mesh
+_scene_african_head(rc::Thread_Pool* workers)
+{
+	return mesh_load(rc::str_fmt(rc::frame_allocator(), "%s/data/african_head/african_head.obj", rc::app_directory()).ptr, workers);
+}
+
+inline static Mesh
+_scene_dino(rc::Thread_Pool* workers)
+{
+	return mesh_load(rc::str_fmt(rc::frame_allocator(), "%s/data/dino.stl", rc::app_directory()).ptr, workers);
+}
+
+// uv sphere of 2 * STACKS * SLICES = 1M triangles, small enough on screen that most of them cover a
+// handful of pixels, which stresses setup and binning instead of filling
+inline static Mesh
+_scene_sphere_1m(rc::Thread_Pool*)
+{
+	static constexpr unsigned STACKS = 500;
+	static constexpr unsigned SLICES = 1000;
+
+	Mesh self = mesh_init();
+	self.uv_indices = rc::vec_init<unsigned>();
+	rc::vec_reserve(self.position, (STACKS + 1) * (SLICES + 1));
+	rc::vec_reserve(self.uv, (STACKS + 1) * (SLICES + 1));
+	rc::vec_reserve(self.indices, STACKS * SLICES * 6);
+	rc::vec_reserve(self.uv_indices, STACKS * SLICES * 6);
+
+	for (unsigned stack = 0; stack <= STACKS; ++stack)
+	{
+		auto v = (float)stack / STACKS;
+		auto phi = v * (float)math::PI;
+		for (unsigned slice = 0; slice <= SLICES; ++slice)
+		{
+			auto u = (float)slice / SLICES;
+			auto theta = u * (float)math::TAU;
+			rc::vec_push(self.position, math::V3{math::sin(phi) * math::cos(theta), math::cos(phi), math::sin(phi) * math::sin(theta)});
+			rc::vec_push(self.uv, math::V2{u, 1.0f - v});
+		}
+	}
+
+	for (unsigned stack = 0; stack < STACKS; ++stack)
+	{
+		for (unsigned slice = 0; slice < SLICES; ++slice)
+		{
+			auto i0 = stack * (SLICES + 1) + slice;
+			auto i1 = i0 + SLICES + 1;
+			unsigned quad[] = {i0, i0 + 1, i1, i1, i0 + 1, i1 + 1};
+			for (auto i: quad)
+			{
+				rc::vec_push(self.indices, i);
+				rc::vec_push(self.uv_indices, i);
+			}
+		}
+	}
+
+	self.bb_min = {-1.0f, -1.0f, -1.0f};
+	self.bb_max = { 1.0f,  1.0f,  1.0f};
+	return self;
+}
+
+// the square in the xy plane with both windings so it shows from either side, rotated uvs run u along y
+// and v along x so each scanline walks down the columns of the texture
+inline static Mesh
+_quad(bool rotated)
+{
+	Mesh self = mesh_init();
+	self.uv_indices = rc::vec_init<unsigned>();
+
+	math::V3 corners[] = {{-1.0f, -1.0f, 0.0f}, {1.0f, -1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {-1.0f, 1.0f, 0.0f}};
+	for (auto p: corners)
+	{
+		rc::vec_push(self.position, p);
+		auto s = (p.x + 1.0f) * 0.5f, t = (p.y + 1.0f) * 0.5f;
+		rc::vec_push(self.uv, rotated ? math::V2{t, s} : math::V2{s, t});
+	}
+
+	unsigned indices[] = {0, 1, 2, 0, 2, 3, 0, 2, 1, 0, 3, 2};
+	for (auto i: indices)
+	{
+		rc::vec_push(self.indices, i);
+		rc::vec_push(self.uv_indices, i);
+	}
+
+	self.bb_min = {-1.0f, -1.0f, 0.0f};
+	self.bb_max = { 1.0f,  1.0f, 0.0f};
+	return self;
+}
+
+// LAYERS copies of the quad stacked along z and submitted in order, from the bench view they come
+// back to front so each one passes the depth test and covers the previous, the worst case of overdraw
+inline static Mesh
+_scene_layers(rc::Thread_Pool*)
+{
+	static constexpr unsigned LAYERS = 16;
+
+	auto quad = _quad(false);
+	Mesh self = mesh_init();
+	self.uv_indices = rc::vec_init<unsigned>();
+	for (unsigned layer = 0; layer < LAYERS; ++layer)
+	{
+		auto offset = (unsigned)self.position.count;
+		auto z = (float)layer / (LAYERS - 1) * 2.0f - 1.0f;
+		for (rc::sz i = 0; i < quad.position.count; ++i)
+		{
+			rc::vec_push(self.position, math::V3{quad.position[i].x, quad.position[i].y, z});
+			rc::vec_push(self.uv, quad.uv[i]);
+		}
+		for (rc::sz i = 0; i < quad.indices.count; ++i)
+		{
+			rc::vec_push(self.indices, quad.indices[i] + offset);
+			rc::vec_push(self.uv_indices, quad.uv_indices[i] + offset);
+		}
+	}
+	mesh_deinit(quad);
+
+	self.bb_min = {-1.0f, -1.0f, -1.0f};
+	self.bb_max = { 1.0f,  1.0f,  1.0f};
+	return self;
+}
+
+inline static Mesh
+_scene_quad(rc::Thread_Pool*)
+{
+	return _quad(false);
+}
+
+inline static Mesh
+_scene_quad_rotated(rc::Thread_Pool*)
+{
+	return _quad(true);
+}
+
+// 2048x2048 of noise, its top levels are far bigger than the caches so the fill rate of the quads
+// follows the memory layout of the texture
+inline static Texture
+_texture_noise(TEXTURE_LAYOUT layout)
+{
+	static constexpr int SIZE = 2048;
+	auto data = rex_alloc_N_from(rc::frame_allocator(), uint8_t, (rc::sz)SIZE * SIZE * 4);
+	rc::u32 state = 2463534242u;
+	for (rc::sz i = 0; i < (rc::sz)SIZE * SIZE; ++i)
+	{
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		data[i * 4 + 0] = (uint8_t)state;
+		data[i * 4 + 1] = (uint8_t)(state >> 8);
+		data[i * 4 + 2] = (uint8_t)(state >> 16);
+		data[i * 4 + 3] = 255;
+	}
+	return texture_from_rgba8(data, SIZE, SIZE, layout);
+}
+
+inline static Texture
+_texture_noise_linear()
+{
+	return _texture_noise(TEXTURE_LAYOUT_LINEAR);
+}
+
+inline static Texture
+_texture_noise_tiled()
+{
+	return _texture_noise(TEXTURE_LAYOUT_TILED);
+}
+
+inline static void
+_usage()
+{
+	fprintf(stderr,
+		"usage: rex-bench [options]\n"
+		"  --width N        frame width (default 1280)\n"
+		"  --height N       frame height (default 720)\n"
+		"  --warmup N       untimed frames before each scene (default 10)\n"
+		"  --frames N       timed frames of each scene (default 100)\n"
+		"  --scene NAME     only run the scenes whose name contains NAME\n"
+		"  --output PATH    json output path (default stdout)\n"
+	);
+}
+
+inline static bool
+_options_parse(Options& self, int argc, char** argv)
+{
+	self.width = 1280;
+	self.height = 720;
+	self.warmup = 10;
+	self.frames = 100;
+	self.filter = nullptr;
+	self.output = nullptr;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		auto arg = argv[i];
+		auto value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if (value == nullptr)
+			return false;
+
+		if (strcmp(arg, "--width") == 0)
+			self.width = atoi(value);
+		else if (strcmp(arg, "--height") == 0)
+			self.height = atoi(value);
+		else if (strcmp(arg, "--warmup") == 0)
+			self.warmup = atoi(value);
+		else if (strcmp(arg, "--frames") == 0)
+			self.frames = atoi(value);
+		else if (strcmp(arg, "--scene") == 0)
+			self.filter = value;
+		else if (strcmp(arg, "--output") == 0)
+			self.output = value;
+		else
+			return false;
+		++i;
+	}
+
+	return self.width > 0 && self.height > 0 && self.warmup >= 0 && self.frames > 0;
+}
+
+inline static const char*
+_kernel_name()
+{
+	auto kernel = raster_triangle_kernel(SHADER_FLAG_DEFAULT);
+#if REX_ARCH_X86
+	if (kernel == raster_triangle_avx2[SHADER_FLAG_DEFAULT])
+		return "avx2";
+	if (kernel == raster_triangle_sse4[SHADER_FLAG_DEFAULT])
+		return "sse4";
+#endif
+	return kernel == raster_triangle_scalar[SHADER_FLAG_DEFAULT] ? "scalar" : "unknown";
+}
+
+inline static Result
+_scene_run(Rex* rex, const Scene& scene, const Options& options)
+{
+	mesh_deinit(rex->mesh);
+	rex->mesh = scene.load(rex->workers);
+	auto texture = rex->texture;
+	if (scene.texture)
+		rex->texture = scene.texture();
+	rex->shader = scene.shader;
+	rc::frame_allocator()->clear();
+
+	Result self = {};
+	self.name = scene.name;
+	self.triangles = (rex->mesh.indices.count ? rex->mesh.indices.count : rex->mesh.position.count) / 3;
+
+	// same view every frame so every run renders the exact same pixels
+	rex->cam = camera_init();
+	rex->cam.rotation = {20.0f * (float)math::TO_RADIAN, 30.0f * (float)math::TO_RADIAN, 0.0f};
+
+	for (int i = 0; i < options.warmup; ++i)
+	{
+		rex->loop(rex);
+		rc::frame_allocator()->clear();
+	}
+
+	Frame_Timings timings = {};
+	rc::u64 frame_ns = 0;
+	for (int i = 0; i < options.frames; ++i)
+	{
+		auto start = rc::time_nanoseconds();
+		rex->loop(rex);
+		frame_ns += rc::time_nanoseconds() - start;
+		rc::frame_allocator()->clear();
+
+		timings.vertex_ns += rex->timings.vertex_ns;
+		timings.setup_ns  += rex->timings.setup_ns;
+		timings.raster_ns += rex->timings.raster_ns;
+		timings.blit_ns   += rex->timings.blit_ns;
+	}
+
+	auto to_ms = 1e-6 / options.frames;
+	self.frame_ms  = frame_ns * to_ms;
+	self.vertex_ms = timings.vertex_ns * to_ms;
+	self.setup_ms  = timings.setup_ns * to_ms;
+	self.raster_ms = timings.raster_ns * to_ms;
+	self.blit_ms   = timings.blit_ns * to_ms;
+	self.stats = rex->stats;
+
+	if (scene.texture)
+	{
+		texture_deinit(rex->texture);
+		rex->texture = texture;
+	}
+	return self;
+}
+
+inline static void
+_result_json(rc::Str& json, const Result& self, const Options& options, bool last)
+{
+	auto frame_s = self.frame_ms * 1e-3;
+	rc::str_append(json, "\t\t{\n");
+	rc::str_append(json, "\t\t\t\"name\": \"%s\",\n", self.name);
+	rc::str_append(json, "\t\t\t\"triangles\": %zu,\n", self.triangles);
+	rc::str_append(json, "\t\t\t\"triangles_rasterized\": %llu,\n", (unsigned long long)self.stats.triangles_rasterized);
+	rc::str_append(json, "\t\t\t\"ms_per_frame\": %.4f,\n", self.frame_ms);
+	rc::str_append(json, "\t\t\t\"stages_ms\": {\"vertex\": %.4f, \"setup\": %.4f, \"raster\": %.4f, \"blit\": %.4f},\n",
+		self.vertex_ms, self.setup_ms, self.raster_ms, self.blit_ms);
+	rc::str_append(json, "\t\t\t\"triangles_per_second\": %.1f,\n", self.triangles / frame_s);
+	rc::str_append(json, "\t\t\t\"pixels_per_second\": %.1f\n", (double)options.width * options.height / frame_s);
+	rc::str_append(json, "\t\t}%s\n", last ? "" : ",");
+}
+
+int main(int argc, char** argv)
+{
+	// TODO: make sure memory allocators initialized first
+	rc::rex_allocator();
+
+	Options options = {};
+	if (_options_parse(options, argc, argv) == false)
+	{
+		_usage();
+		return 1;
+	}
+
+	constexpr auto VISIBILITY = SHADER_FLAG_DEFAULT | SHADER_FLAG_VISIBILITY;
+	Scene scenes[] = {
+		{"cube", _scene_cube, nullptr, SHADER_FLAG_DEFAULT},
+		{"african_head", _scene_african_head, nullptr, SHADER_FLAG_DEFAULT},
+		{"dino", _scene_dino, nullptr, SHADER_FLAG_DEFAULT},
+		{"sphere_1m", _scene_sphere_1m, nullptr, SHADER_FLAG_DEFAULT},
+		// the same texture in both layouts, the rotated quad is where the linear layout misses the most
+		{"quad_linear", _scene_quad, _texture_noise_linear, SHADER_FLAG_DEFAULT},
+		{"quad_tiled", _scene_quad, _texture_noise_tiled, SHADER_FLAG_DEFAULT},
+		{"quad_rotated_linear", _scene_quad_rotated, _texture_noise_linear, SHADER_FLAG_DEFAULT},
+		{"quad_rotated_tiled", _scene_quad_rotated, _texture_noise_tiled, SHADER_FLAG_DEFAULT},
+		// forward shading against visibility rendering, with little and with a lot of overdraw
+		{"african_head_visibility", _scene_african_head, nullptr, VISIBILITY},
+		{"layers", _scene_layers, _texture_noise_tiled, SHADER_FLAG_DEFAULT},
+		{"layers_visibility", _scene_layers, _texture_noise_tiled, VISIBILITY},
+	};
+
+	auto rex = (Rex*)load_rex_api();
+	rex->init(rex);
+
+	rex->screen_width = options.width;
+	rex->screen_height = options.height;
+	rex->screen = rex_alloc_N(Rex_Pixel, (rc::sz)options.width * options.height);
+	rex->dt = 0.033f;
+
+	auto results = rc::vec_init<Result>();
+	for (const auto& scene: scenes)
+	{
+		if (options.filter && strstr(scene.name, options.filter) == nullptr)
+			continue;
+
+		rc::vec_push(results, _scene_run(rex, scene, options));
+		fprintf(stderr, "[rex-bench]: %s %.3f ms/frame\n", scene.name, results[results.count - 1].frame_ms);
+	}
+
+	auto json = rc::str_init();
+	rc::str_append(json, "{\n");
+	rc::str_append(json, "\t\"width\": %d,\n", options.width);
+	rc::str_append(json, "\t\"height\": %d,\n", options.height);
+	rc::str_append(json, "\t\"frames\": %d,\n", options.frames);
+	rc::str_append(json, "\t\"workers\": %u,\n", rc::thread_pool_workers_count(rex->workers));
+	rc::str_append(json, "\t\"kernel\": \"%s\",\n", _kernel_name());
+	rc::str_append(json, "\t\"scenes\": [\n");
+	for (rc::sz i = 0; i < results.count; ++i)
+		_result_json(json, results[i], options, i + 1 == results.count);
+	rc::str_append(json, "\t]\n");
+	rc::str_append(json, "}\n");
+
+	auto file = options.output ? fopen(options.output, "wb") : stdout;
+	if (file == nullptr)
+	{
+		rex_log_error("[rex-bench]: failed to open '%s'", options.output);
+	}
+	else
+	{
+		fwrite(json.ptr, 1, json.count, file);
+		if (file != stdout)
+			fclose(file);
+	}
+
+	rc::str_deinit(json);
+	rc::vec_deinit(results);
+	rex_dealloc(rex->screen);
+	rex->deinit(rex);
+	return file ? 0 : 1;
+}
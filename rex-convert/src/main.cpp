@@ -0,0 +1,90 @@
+#include <rex-core/file.h>
+#include <rex-core/memory.h>
+#include <rex-core/str.h>
+#include <rex-core/thread.h>
+#include <rex-core/time.h>
+#include <rex-core/log.h>
+
+#include <rex-raster/gltf.h>
+#include <rex-raster/mesh.h>
+
+#include <stdio.h>
+
+// converts obj, stl and gltf meshes to .rexmesh, e.g.
+// rex-convert data/african_head/african_head.obj head.rexmesh
+// without an output it writes the "<input>.rexmesh" cache mesh_load looks for, .gltf files have no cache
+// since their buffers are other files so they need an explicit output
+
+using namespace rex::raster;
+
+inline static void
+_usage()
+{
+	fprintf(stderr,
+		"usage: rex-convert INPUT [OUTPUT]\n"
+		"  INPUT   .obj, .stl, .gltf or .glb mesh\n"
+		"  OUTPUT  .rexmesh path (default INPUT.rexmesh, the cache the loaders check, required for .gltf)\n"
+	);
+}
+
+inline static Mesh
+_mesh_parse(const char* path, rc::Thread_Pool* workers)
+{
+	if (rc::file_has_extension(path, ".stl"))
+		return mesh_from_stl(path);
+	if (rc::file_has_extension(path, ".gltf") || rc::file_has_extension(path, ".glb"))
+		return mesh_from_gltf(path);
+	return mesh_from_obj(path, workers);
+}
+
+int main(int argc, char** argv)
+{
+	// TODO: make sure memory allocators initialized first
+	rc::rex_allocator();
+
+	if (argc != 2 && argc != 3)
+	{
+		_usage();
+		return 1;
+	}
+
+	auto input = argv[1];
+	if (argc == 2 && rc::file_has_extension(input, ".gltf"))
+	{
+		rex_log_error("[rex-convert]: '%s' has no cache to write, give an OUTPUT path", input);
+		_usage();
+		return 1;
+	}
+
+	auto source = rc::file_info(input);
+	if (source.exists == false)
+	{
+		rex_log_error("[rex-convert]: '%s' doesn't exist", input);
+		return 1;
+	}
+
+	// only the cache path remembers where it came from, standalone files load regardless of the source
+	auto output = argc == 3 ? rc::str_from(argv[2]) : rc::str_fmt("%s.rexmesh", input);
+	auto key = argc == 3 ? rc::File_Info{} : source;
+
+	auto workers = rc::thread_pool_init();
+	auto start = rc::time_nanoseconds();
+	auto mesh = _mesh_parse(input, workers);
+	auto parse_ns = rc::time_nanoseconds() - start;
+
+	auto succeeded = mesh.position.count && mesh_save_rexmesh(mesh, output.ptr, key);
+	if (succeeded)
+	{
+		fprintf(stderr, "[rex-convert]: %s -> %s, %zu vertices, %zu triangles, parsed in %.2f ms\n", input, output.ptr,
+			(size_t)mesh.position.count, (size_t)(mesh.indices.count ? mesh.indices.count : mesh.position.count) / 3, parse_ns * 1e-6);
+	}
+	else
+	{
+		rex_log_error("[rex-convert]: failed to convert '%s' to '%s'", input, output.ptr);
+	}
+
+	mesh_deinit(mesh);
+	rc::thread_pool_deinit(workers);
+	rc::str_deinit(output);
+	return succeeded ? 0 : 1;
+}
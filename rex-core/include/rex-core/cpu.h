@@ -0,0 +1,17 @@
+#pragma once
+
+#include "rex-core/exports.h"
+#include "rex-core/types.h"
+
+namespace rc
+{
+	// instruction sets usable on the running cpu, the os support for saving the wide registers is
+	// checked as well so it's safe to dispatch on these at runtime
+	struct Cpu_Features
+	{
+		bool sse41;
+		bool avx2;
+	};
+
+	REX_CORE_EXPORT Cpu_Features cpu_features();
+}
@@ -0,0 +1,42 @@
+
+#ifndef REX_CORE_EXPORT_H
+#define REX_CORE_EXPORT_H
+
+#ifdef REX_CORE_STATIC_DEFINE
+#  define REX_CORE_EXPORT
+#  define REX_CORE_NO_EXPORT
+#else
+#  ifndef REX_CORE_EXPORT
+#    ifdef rex_core_EXPORTS
+        /* We are building this library */
+#      define REX_CORE_EXPORT 
+#    else
+        /* We are using this library */
+#      define REX_CORE_EXPORT 
+#    endif
+#  endif
+
+#  ifndef REX_CORE_NO_EXPORT
+#    define REX_CORE_NO_EXPORT 
+#  endif
+#endif
+
+#ifndef REX_CORE_DEPRECATED
+#  define REX_CORE_DEPRECATED __attribute__ ((__deprecated__))
+#endif
+
+#ifndef REX_CORE_DEPRECATED_EXPORT
+#  define REX_CORE_DEPRECATED_EXPORT REX_CORE_EXPORT REX_CORE_DEPRECATED
+#endif
+
+#ifndef REX_CORE_DEPRECATED_NO_EXPORT
+#  define REX_CORE_DEPRECATED_NO_EXPORT REX_CORE_NO_EXPORT REX_CORE_DEPRECATED
+#endif
+
+#if 0 /* DEFINE_NO_DEPRECATED */
+#  ifndef REX_CORE_NO_DEPRECATED
+#    define REX_CORE_NO_DEPRECATED
+#  endif
+#endif
+
+#endif /* REX_CORE_EXPORT_H */
@@ -14,4 +14,40 @@ namespace rc
 	{
 		return file_read(str_lit(path), allocator);
 	}
+
+	// read only view of a whole file, mapped where the os supports it so nothing is copied. the view isn't
+	// null terminated, ptr is null when the file can't be opened
+	struct File_Map
+	{
+		const char* ptr;
+		sz count;
+		// address of the mapping to release, or of the copy of the file where it can't be mapped
+		void* handle;
+	};
+
+	REX_CORE_EXPORT File_Map file_map(const char* path);
+	REX_CORE_EXPORT void file_unmap(File_Map& self);
+
+	struct File_Info
+	{
+		bool exists;
+		u64 size;
+		// last modification time in nanoseconds since an os defined epoch, only good for comparisons
+		i64 modified_ns;
+	};
+
+	REX_CORE_EXPORT File_Info file_info(const char* path);
+
+	// ascii case insensitive, extension is lowercase with its dot, e.g. ".obj"
+	inline static bool
+	file_has_extension(const char* path, const char* extension)
+	{
+		auto path_count = str_len(path), extension_count = str_len(extension);
+		if (path_count < extension_count)
+			return false;
+		for (sz i = 0; i < extension_count; ++i)
+			if ((path[path_count - extension_count + i] | 0x20) != extension[i])
+				return false;
+		return true;
+	}
 }
@@ -0,0 +1,127 @@
+#pragma once
+
+#include "rex-core/exports.h"
+#include "rex-core/memory.h"
+#include "rex-core/str.h"
+
+#include <string.h>
+
+// json parsing without copying the text, strings and keys are views into the source which must outlive the
+// values and keep their escapes until json_unescape decodes them. json_sax streams the values to callbacks,
+// json_parse builds a document in a single allocation
+
+namespace rc
+{
+	enum JSON_TYPE : u8
+	{
+		JSON_NULL,
+		JSON_BOOL,
+		JSON_NUMBER,
+		JSON_STRING,
+		JSON_ARRAY,
+		JSON_OBJECT,
+	};
+
+	struct Json
+	{
+		JSON_TYPE type;
+		// elements of arrays and members of objects, bytes of strings
+		u32 count;
+		// member name when the value is inside an object, null otherwise
+		const char* key;
+		u32 key_count;
+		u32 key_hash;
+		union
+		{
+			bool as_bool;
+			double as_number;
+			const char* as_string;
+			// children of arrays and objects in document order
+			const Json* values;
+		};
+	};
+
+	// nesting deeper than this is rejected instead of exhausting the stack
+	static constexpr u32 JSON_MAX_DEPTH = 256;
+
+	// containers report their begin and end around their children, everything else is a value. scalars are
+	// complete values, containers only have their type and key set in begin and their count in end. returning
+	// false from a callback stops the parse which then fails
+	struct Json_Events
+	{
+		bool (*begin)(void* data, const Json& value);
+		bool (*end)(void* data, const Json& value);
+		bool (*value)(void* data, const Json& value);
+	};
+
+	REX_CORE_EXPORT bool json_sax(const char* first, const char* last, const Json_Events& events, void* data);
+
+	struct Json_Document
+	{
+		// the single allocation holding every value
+		Json* values;
+		Allocator allocator;
+		// null when the text isn't valid json
+		const Json* root;
+	};
+
+	REX_CORE_EXPORT Json_Document json_parse(const char* first, const char* last, Allocator allocator = rex_allocator());
+	REX_CORE_EXPORT void json_deinit(Json_Document& self);
+
+	// fnv-1a, the hash member keys are stored with
+	inline static u32
+	json_hash(const char* ptr, sz count)
+	{
+		u32 hash = 2166136261u;
+		for (sz i = 0; i < count; ++i)
+			hash = (hash ^ (u8)ptr[i]) * 16777619u;
+		return hash;
+	}
+
+	// member of an object by name, compares the stored hashes before the bytes, null when missing or not an object
+	REX_CORE_EXPORT const Json* json_find(const Json* object, const char* key, sz key_count);
+
+	inline static const Json*
+	json_find(const Json* object, const char* key)
+	{
+		return json_find(object, key, ::strlen(key));
+	}
+
+	inline static const Json*
+	json_at(const Json* array, sz index)
+	{
+		if (array == nullptr || array->type != JSON_ARRAY || index >= array->count)
+			return nullptr;
+		return &array->values[index];
+	}
+
+	// elements of an array, 0 for anything else
+	inline static sz
+	json_count(const Json* array)
+	{
+		return array && array->type == JSON_ARRAY ? array->count : 0;
+	}
+
+	inline static double
+	json_number(const Json* value, double fallback)
+	{
+		return value && value->type == JSON_NUMBER ? value->as_number : fallback;
+	}
+
+	inline static bool
+	json_bool(const Json* value, bool fallback)
+	{
+		return value && value->type == JSON_BOOL ? value->as_bool : fallback;
+	}
+
+	// compares the raw bytes so strings with escapes only equal the same escapes
+	inline static bool
+	json_string_equals(const Json* value, const char* str)
+	{
+		auto count = ::strlen(str);
+		return value && value->type == JSON_STRING && value->count == count && ::memcmp(value->as_string, str, count) == 0;
+	}
+
+	// decodes the escapes of a string, \u escapes are written as utf-8. returns an empty string for invalid escapes
+	REX_CORE_EXPORT Str json_unescape(const Json& value, Allocator allocator = rex_allocator());
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "rex-core/exports.h"
+#include "rex-core/types.h"
+
+// batch conversions of pixel buffers, each runs the widest simd kernel the cpu supports. counts are in
+// channels for the u8 <-> f32 conversions and in 4 byte pixels for the rest. src and dst may be the same
+// buffer but must not partially overlap
+
+namespace rc
+{
+	// c / 255
+	REX_CORE_EXPORT void pixels_u8_to_f32(const u8* src, f32* dst, sz count);
+
+	// c * 255 clamped to [0, 255] and truncated, nan is 0
+	REX_CORE_EXPORT void pixels_f32_to_u8(const f32* src, u8* dst, sz count);
+
+	// swaps the first and third byte of every pixel, rgba to bgra and back
+	REX_CORE_EXPORT void pixels_swizzle_rb(const u32* src, u32* dst, sz count);
+
+	// multiplies the first three bytes of every pixel by the fourth, alpha last in either rgba or bgra,
+	// rounded to the nearest
+	REX_CORE_EXPORT void pixels_premultiply(const u32* src, u32* dst, sz count);
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "rex-core/exports.h"
+#include "rex-core/types.h"
+#include "rex-core/time.h"
+
+// scoped zones recorded into per thread ring buffers, e.g.
+//	rc::profile_enable(true);
+//	{ rex_profile_zone("raster"); ... }
+//	rc::profile_frame_mark();
+//	rc::profile_dump_chrome_trace("trace.json", 10);
+//
+// built with REX_PROFILE=0 the macros compile to nothing, otherwise a disabled profiler costs a call
+// and a branch per zone
+
+namespace rc
+{
+	// events each thread keeps before overwriting its oldest ones
+	static constexpr u32 PROFILE_THREAD_EVENTS = 1 << 16;
+	static constexpr u32 PROFILE_MAX_THREADS = 64;
+	static constexpr u32 PROFILE_MAX_FRAMES = 256;
+
+	REX_CORE_EXPORT void profile_enable(bool enabled);
+	REX_CORE_EXPORT bool profile_enabled();
+
+	// records a zone on the calling thread's ring buffer, name must outlive the profiler (use literals)
+	REX_CORE_EXPORT void profile_zone_record(const char* name, u64 start_ns, u64 end_ns);
+
+	// marks the start of a new frame, call it from one thread between frames
+	REX_CORE_EXPORT void profile_frame_mark();
+
+	// writes the zones of the last frames_count complete frames as chrome trace event json (load it in
+	// chrome://tracing or https://ui.perfetto.dev), 0 dumps everything still in the buffers. no zone
+	// may be recorded while dumping
+	REX_CORE_EXPORT bool profile_dump_chrome_trace(const char* path, u32 frames_count = 0);
+
+	struct Profile_Zone
+	{
+		const char* name;
+		u64 start_ns;
+
+		Profile_Zone(const char* name)
+		{
+			this->name = profile_enabled() ? name : nullptr;
+			this->start_ns = this->name ? time_nanoseconds() : 0;
+		}
+
+		~Profile_Zone()
+		{
+			if (name)
+				profile_zone_record(name, start_ns, time_nanoseconds());
+		}
+	};
+}
+
+#ifndef REX_PROFILE
+# define REX_PROFILE 0
+#endif
+
+#define rex_PROFILE_1(x, y) x##y
+#define rex_PROFILE_2(x, y) rex_PROFILE_1(x, y)
+#define rex_PROFILE_3(x)    rex_PROFILE_2(x, __COUNTER__)
+
+#if REX_PROFILE
+# define rex_profile_zone(name) rc::Profile_Zone rex_PROFILE_3(_profile_zone_)(name)
+# define rex_profile_function() rex_profile_zone(__FUNCTION__)
+// records a zone timed by the caller, for stages that already take timestamps
+# define rex_profile_record(name, start_ns, end_ns) do { if (rc::profile_enabled()) rc::profile_zone_record(name, start_ns, end_ns); } while (0)
+#else
+# define rex_profile_zone(name) // do nothing
+# define rex_profile_function() // do nothing
+# define rex_profile_record(name, start_ns, end_ns) // do nothing
+#endif
@@ -40,6 +40,11 @@ namespace rc
 	// TODO: write unit tests
 	REX_CORE_EXPORT Vec<Str> str_lines(const Str& self, Allocator allocator = rex_allocator());
 	REX_CORE_EXPORT Vec<Str> str_split(const Str& self, char c, Allocator allocator = rex_allocator());
+	// parse a number at the start of [first, last) and return the count of characters consumed, 0 when there's
+	// no number there. doubles accept an optional sign, a decimal point, e/E exponents, inf, infinity and nan,
+	// are correctly rounded and never allocate
+	REX_CORE_EXPORT sz str_parse_double(const char* first, const char* last, double* value);
+	REX_CORE_EXPORT sz str_parse_int(const char* first, const char* last, int64_t* value);
 	// TODO: use Res instead of boolean pointer
 	REX_CORE_EXPORT double str_to_double(const Str& self, bool* succeeded);
 	REX_CORE_EXPORT int64_t str_to_int(const Str& self, bool* succeeded);
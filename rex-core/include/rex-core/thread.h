@@ -0,0 +1,23 @@
+#pragma once
+
+#include "rex-core/exports.h"
+#include "rex-core/types.h"
+
+namespace rc
+{
+	// called once for every index in [0, count), worker is in [0, thread_pool_workers_count)
+	// NOTE: allocators aren't thread safe, don't allocate inside tasks
+	using task_proc_t = void (*)(void* user_data, u32 index, u32 worker);
+
+	struct Thread_Pool;
+
+	REX_CORE_EXPORT u32 thread_cores_count();
+
+	// workers_count = 0 means one worker per core, the calling thread is always worker 0
+	REX_CORE_EXPORT Thread_Pool* thread_pool_init(u32 workers_count = 0);
+	REX_CORE_EXPORT void thread_pool_deinit(Thread_Pool* self);
+	REX_CORE_EXPORT u32 thread_pool_workers_count(const Thread_Pool* self);
+
+	// blocks until all the tasks are done
+	REX_CORE_EXPORT void thread_pool_run(Thread_Pool* self, u32 count, task_proc_t proc, void* user_data);
+}
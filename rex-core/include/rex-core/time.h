@@ -3,6 +3,9 @@
 
 namespace rc
 {
+	// milliseconds elapsed since the previous call
 	REX_CORE_EXPORT i64 time_milliseconds();
+	// monotonic timestamp, only the difference between two calls is meaningful
+	REX_CORE_EXPORT u64 time_nanoseconds();
 	REX_CORE_EXPORT void sleep(u32 milliseconds);
 }
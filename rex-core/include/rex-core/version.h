@@ -0,0 +1,5 @@
+#pragma once
+
+#define REX_VERSION_MAJOR 2021
+#define REX_VERSION_MINOR 12
+#define REX_VERSION_PATCH 0
@@ -126,5 +126,8 @@ namespace rc
 	REX_CORE_EXPORT void window_deinit(Window* self);
 	REX_CORE_EXPORT void window_poll(Window* self);
 	REX_CORE_EXPORT void window_title_set(Window* self, const char* title);
+	// memory to render the next frame into, blitting it skips the copy to the presentation buffer,
+	// returns nullptr when the platform has no such buffer
+	REX_CORE_EXPORT uint32_t* window_back_buffer(Window* self, i32 width, i32 height);
 	REX_CORE_EXPORT void window_blit(Window* self, uint32_t* pixels, i32 width, i32 height);
 }
@@ -0,0 +1,78 @@
+#include "rex-core/cpu.h"
+
+#if REX_ARCH_X86
+	#if REX_COMPILER_MSVC
+		#include <intrin.h>
+	#else
+		#include <cpuid.h>
+	#endif
+#endif
+
+namespace rc
+{
+#if REX_ARCH_X86
+	inline static void
+	_cpuid(u32 leaf, u32 subleaf, u32 (&regs)[4])
+	{
+	#if REX_COMPILER_MSVC
+		int r[4] = {};
+		__cpuidex(r, (int)leaf, (int)subleaf);
+		for (int i = 0; i < 4; ++i)
+			regs[i] = (u32)r[i];
+	#else
+		__cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+	#endif
+	}
+
+	inline static u64
+	_xgetbv()
+	{
+	#if REX_COMPILER_MSVC
+		return _xgetbv(0);
+	#else
+		u32 eax = 0, edx = 0;
+		__asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+		return ((u64)edx << 32) | eax;
+	#endif
+	}
+
+	inline static Cpu_Features
+	_cpu_features_query()
+	{
+		Cpu_Features self = {};
+
+		u32 regs[4] = {};
+		_cpuid(0, 0, regs);
+		auto max_leaf = regs[0];
+		if (max_leaf < 1)
+			return self;
+
+		_cpuid(1, 0, regs);
+		self.sse41 = regs[2] & (1u << 19);
+
+		// avx needs the os to save the ymm registers on context switch (xcr0 bits 1 and 2)
+		bool osxsave = regs[2] & (1u << 27);
+		bool avx = regs[2] & (1u << 28);
+		if (osxsave && avx && (_xgetbv() & 0x6) == 0x6 && max_leaf >= 7)
+		{
+			_cpuid(7, 0, regs);
+			self.avx2 = regs[1] & (1u << 5);
+		}
+
+		return self;
+	}
+#else
+	inline static Cpu_Features
+	_cpu_features_query()
+	{
+		return Cpu_Features{};
+	}
+#endif
+
+	Cpu_Features
+	cpu_features()
+	{
+		static Cpu_Features self = _cpu_features_query();
+		return self;
+	}
+}
@@ -0,0 +1,442 @@
+#include "rex-core/json.h"
+#include "rex-core/assert.h"
+
+namespace rc
+{
+	struct _Json_Reader
+	{
+		const char* it;
+		const char* end;
+		u32 depth;
+	};
+
+	inline static void
+	_json_skip_spaces(_Json_Reader& self)
+	{
+		while (self.it < self.end && (*self.it == ' ' || *self.it == '\t' || *self.it == '\n' || *self.it == '\r'))
+			++self.it;
+	}
+
+	// view of the string at the cursor without its quotes, escapes are skipped over and kept
+	inline static bool
+	_json_string(_Json_Reader& self, const char** ptr, u32* count)
+	{
+		if (self.it == self.end || *self.it != '"')
+			return false;
+
+		auto first = ++self.it;
+		while (true)
+		{
+			auto quote = (const char*)::memchr(self.it, '"', (sz)(self.end - self.it));
+			if (quote == nullptr)
+				return false;
+
+			// the quote is escaped when an odd count of backslashes precedes it
+			auto backslashes = quote;
+			while (backslashes > first && backslashes[-1] == '\\')
+				--backslashes;
+			self.it = quote + 1;
+			if (((quote - backslashes) & 1) == 0)
+				break;
+		}
+
+		*ptr = first;
+		*count = (u32)(self.it - 1 - first);
+		return true;
+	}
+
+	inline static bool
+	_json_literal(_Json_Reader& self, const char* literal, sz count)
+	{
+		if ((sz)(self.end - self.it) < count || ::memcmp(self.it, literal, count) != 0)
+			return false;
+		self.it += count;
+		return true;
+	}
+
+	// the tokenizer is shared by the sax and the document handlers, their callbacks are overloads picked at
+	// compile time so the document doesn't pay for function pointers
+	template <typename T>
+	inline static bool
+	_json_value(_Json_Reader& self, T& handler, const char* key, u32 key_count)
+	{
+		_json_skip_spaces(self);
+		if (self.it == self.end)
+			return false;
+
+		Json value = {};
+		value.key = key;
+		value.key_count = key_count;
+		value.key_hash = key ? json_hash(key, key_count) : 0;
+
+		auto c = *self.it;
+		if (c == '{' || c == '[')
+		{
+			if (self.depth == JSON_MAX_DEPTH)
+				return false;
+			++self.depth;
+
+			value.type = c == '{' ? JSON_OBJECT : JSON_ARRAY;
+			if (_json_begin(handler, value) == false)
+				return false;
+
+			auto close = c == '{' ? '}' : ']';
+			++self.it;
+			_json_skip_spaces(self);
+			if (self.it < self.end && *self.it == close)
+			{
+				++self.it;
+			}
+			else
+			{
+				while (true)
+				{
+					const char* child_key = nullptr;
+					u32 child_key_count = 0;
+					if (value.type == JSON_OBJECT)
+					{
+						_json_skip_spaces(self);
+						if (_json_string(self, &child_key, &child_key_count) == false)
+							return false;
+						_json_skip_spaces(self);
+						if (self.it == self.end || *self.it != ':')
+							return false;
+						++self.it;
+					}
+
+					if (_json_value(self, handler, child_key, child_key_count) == false)
+						return false;
+					++value.count;
+
+					_json_skip_spaces(self);
+					if (self.it < self.end && *self.it == ',')
+					{
+						++self.it;
+						continue;
+					}
+					if (self.it < self.end && *self.it == close)
+					{
+						++self.it;
+						break;
+					}
+					return false;
+				}
+			}
+
+			--self.depth;
+			return _json_end(handler, value);
+		}
+
+		if (c == '"')
+		{
+			value.type = JSON_STRING;
+			if (_json_string(self, &value.as_string, &value.count) == false)
+				return false;
+		}
+		else if (c == '-' || (c >= '0' && c <= '9'))
+		{
+			// str_parse_double also takes inf and nan which json doesn't have
+			auto digit = c == '-' ? self.it + 1 : self.it;
+			if (digit == self.end || *digit < '0' || *digit > '9')
+				return false;
+			value.type = JSON_NUMBER;
+			auto count = str_parse_double(self.it, self.end, &value.as_number);
+			if (count == 0)
+				return false;
+			self.it += count;
+		}
+		else if (_json_literal(self, "true", 4))
+		{
+			value.type = JSON_BOOL;
+			value.as_bool = true;
+		}
+		else if (_json_literal(self, "false", 5))
+		{
+			value.type = JSON_BOOL;
+			value.as_bool = false;
+		}
+		else if (_json_literal(self, "null", 4))
+		{
+			value.type = JSON_NULL;
+		}
+		else
+		{
+			return false;
+		}
+		return _json_scalar(handler, value);
+	}
+
+	template <typename T>
+	inline static bool
+	_json_read(const char* first, const char* last, T& handler)
+	{
+		_Json_Reader self = {};
+		self.it = first;
+		self.end = last;
+		if (_json_value(self, handler, nullptr, 0) == false)
+			return false;
+		_json_skip_spaces(self);
+		return self.it == self.end;
+	}
+
+	struct _Json_Sax
+	{
+		const Json_Events* events;
+		void* data;
+	};
+
+	inline static bool
+	_json_begin(_Json_Sax& self, const Json& value)
+	{
+		return self.events->begin == nullptr || self.events->begin(self.data, value);
+	}
+
+	inline static bool
+	_json_end(_Json_Sax& self, const Json& value)
+	{
+		return self.events->end == nullptr || self.events->end(self.data, value);
+	}
+
+	inline static bool
+	_json_scalar(_Json_Sax& self, const Json& value)
+	{
+		return self.events->value == nullptr || self.events->value(self.data, value);
+	}
+
+	// finished containers are packed at the front of the values, the stack of values whose container is still
+	// open grows down from the back. a value is always in exactly one of them so counting the values up front
+	// sizes the allocation
+	struct _Json_Builder
+	{
+		Json* values;
+		u32 capacity;
+		u32 packed;
+		u32 stack;
+		u32 depth;
+		// stack size when each open container began
+		u32 marks[JSON_MAX_DEPTH];
+	};
+
+	inline static bool
+	_json_push(_Json_Builder& self, const Json& value)
+	{
+		if (self.packed + self.stack >= self.capacity)
+			return false;
+		++self.stack;
+		self.values[self.capacity - self.stack] = value;
+		return true;
+	}
+
+	inline static bool
+	_json_begin(_Json_Builder& self, const Json&)
+	{
+		self.marks[self.depth++] = self.stack;
+		return true;
+	}
+
+	inline static bool
+	_json_end(_Json_Builder& self, const Json& value)
+	{
+		// the children sit reversed on the stack, put them in order and move them down to their packed slots
+		// which may overlap the stack when the allocation is full, then push the container itself
+		auto mark = self.marks[--self.depth];
+		auto count = self.stack - mark;
+		auto first = &self.values[self.capacity - self.stack];
+		for (u32 i = 0; i < count / 2; ++i)
+		{
+			auto tmp = first[i];
+			first[i] = first[count - 1 - i];
+			first[count - 1 - i] = tmp;
+		}
+		auto children = &self.values[self.packed];
+		::memmove((void*)children, first, count * sizeof(Json));
+		self.packed += count;
+		self.stack = mark;
+
+		auto container = value;
+		container.values = children;
+		return _json_push(self, container);
+	}
+
+	inline static bool
+	_json_scalar(_Json_Builder& self, const Json& value)
+	{
+		return _json_push(self, value);
+	}
+
+	// upper bound of the values count, every value but the root follows a comma or opens a container
+	inline static u32
+	_json_values_bound(const char* it, const char* end)
+	{
+		u32 count = 1;
+		for (; it < end; ++it)
+		{
+			if (*it == '"')
+			{
+				for (++it; it < end && *it != '"'; ++it)
+					if (*it == '\\')
+						++it;
+			}
+			else if (*it == ',' || *it == '[' || *it == '{')
+			{
+				++count;
+			}
+		}
+		return count;
+	}
+
+	inline static int
+	_json_hex_digit(char c)
+	{
+		if (c >= '0' && c <= '9')
+			return c - '0';
+		if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+			return (c | 0x20) - 'a' + 10;
+		return -1;
+	}
+
+	inline static bool
+	_json_code_unit(const char* it, const char* end, u32* value)
+	{
+		if (end - it < 4)
+			return false;
+		*value = 0;
+		for (int i = 0; i < 4; ++i)
+		{
+			auto digit = _json_hex_digit(it[i]);
+			if (digit < 0)
+				return false;
+			*value = *value * 16 + (u32)digit;
+		}
+		return true;
+	}
+
+	bool
+	json_sax(const char* first, const char* last, const Json_Events& events, void* data)
+	{
+		_Json_Sax self = {&events, data};
+		return _json_read(first, last, self);
+	}
+
+	Json_Document
+	json_parse(const char* first, const char* last, Allocator allocator)
+	{
+		_Json_Builder self = {};
+		self.capacity = _json_values_bound(first, last);
+		self.values = rex_alloc_N_from(allocator, Json, self.capacity);
+
+		// the root is the only value left on the stack
+		Json_Document document = {};
+		document.values = self.values;
+		document.allocator = allocator;
+		if (_json_read(first, last, self))
+			document.root = &self.values[self.capacity - 1];
+		return document;
+	}
+
+	void
+	json_deinit(Json_Document& self)
+	{
+		if (self.values)
+			rex_dealloc_from(self.allocator, self.values);
+		self = Json_Document{};
+	}
+
+	const Json*
+	json_find(const Json* object, const char* key, sz key_count)
+	{
+		if (object == nullptr || object->type != JSON_OBJECT)
+			return nullptr;
+
+		auto hash = json_hash(key, key_count);
+		for (u32 i = 0; i < object->count; ++i)
+		{
+			auto& member = object->values[i];
+			if (member.key_hash == hash && member.key_count == key_count && ::memcmp(member.key, key, key_count) == 0)
+				return &member;
+		}
+		return nullptr;
+	}
+
+	Str
+	json_unescape(const Json& value, Allocator allocator)
+	{
+		rex_assert(value.type == JSON_STRING);
+
+		// escapes never decode to more bytes than they take
+		auto self = vec_with_capacity<char>(value.count + 1, allocator);
+		auto it = value.as_string, end = value.as_string + value.count;
+		while (it < end)
+		{
+			if (*it != '\\')
+			{
+				self.ptr[self.count++] = *it++;
+				continue;
+			}
+
+			if (++it == end)
+				break;
+			auto c = *it++;
+			switch (c)
+			{
+				case '"':
+				case '\\':
+				case '/': self.ptr[self.count++] = c; continue;
+				case 'b': self.ptr[self.count++] = '\b'; continue;
+				case 'f': self.ptr[self.count++] = '\f'; continue;
+				case 'n': self.ptr[self.count++] = '\n'; continue;
+				case 'r': self.ptr[self.count++] = '\r'; continue;
+				case 't': self.ptr[self.count++] = '\t'; continue;
+				default: break;
+			}
+
+			u32 code = 0;
+			if (c != 'u' || _json_code_unit(it, end, &code) == false)
+				break;
+			it += 4;
+
+			// utf-16 surrogate pairs are two escapes
+			if (code >= 0xD800 && code <= 0xDBFF)
+			{
+				u32 low = 0;
+				if (end - it < 6 || it[0] != '\\' || it[1] != 'u' || _json_code_unit(it + 2, end, &low) == false || low < 0xDC00 || low > 0xDFFF)
+					break;
+				it += 6;
+				code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+			}
+			else if (code >= 0xDC00 && code <= 0xDFFF)
+			{
+				break;
+			}
+
+			if (code < 0x80)
+			{
+				self.ptr[self.count++] = (char)code;
+			}
+			else if (code < 0x800)
+			{
+				self.ptr[self.count++] = (char)(0xC0 | (code >> 6));
+				self.ptr[self.count++] = (char)(0x80 | (code & 0x3F));
+			}
+			else if (code < 0x10000)
+			{
+				self.ptr[self.count++] = (char)(0xE0 | (code >> 12));
+				self.ptr[self.count++] = (char)(0x80 | ((code >> 6) & 0x3F));
+				self.ptr[self.count++] = (char)(0x80 | (code & 0x3F));
+			}
+			else
+			{
+				self.ptr[self.count++] = (char)(0xF0 | (code >> 18));
+				self.ptr[self.count++] = (char)(0x80 | ((code >> 12) & 0x3F));
+				self.ptr[self.count++] = (char)(0x80 | ((code >> 6) & 0x3F));
+				self.ptr[self.count++] = (char)(0x80 | (code & 0x3F));
+			}
+		}
+
+		// stopped before the end on an invalid escape
+		if (it < end)
+			self.count = 0;
+		self.ptr[self.count] = '\0';
+		return self;
+	}
+}
@@ -2,6 +2,7 @@
 
 #include "rex-core/file.h"
 
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -33,6 +34,66 @@ namespace rc
 
 		return res;
 	}
+
+	File_Map
+	file_map(const char* path)
+	{
+		auto handle = ::open(path, O_RDONLY);
+		if (handle == -1)
+			return {};
+
+		struct stat s = {};
+		if (::fstat(handle, &s) != 0)
+		{
+			::close(handle);
+			return {};
+		}
+
+		// empty files can't be mapped, hand out an empty view instead
+		File_Map self = {};
+		self.ptr = "";
+		if (s.st_size > 0)
+		{
+			auto ptr = ::mmap(nullptr, (size_t)s.st_size, PROT_READ, MAP_PRIVATE, handle, 0);
+			if (ptr == MAP_FAILED)
+			{
+				::close(handle);
+				return {};
+			}
+
+			// loaders read front to back, let the kernel read ahead aggressively
+			::madvise(ptr, (size_t)s.st_size, MADV_SEQUENTIAL);
+			self.ptr = (const char*)ptr;
+			self.count = (sz)s.st_size;
+			self.handle = ptr;
+		}
+
+		// the mapping keeps the file alive on its own
+		::close(handle);
+		return self;
+	}
+
+	void
+	file_unmap(File_Map& self)
+	{
+		if (self.handle)
+			::munmap(self.handle, self.count);
+		self = {};
+	}
+
+	File_Info
+	file_info(const char* path)
+	{
+		struct stat s = {};
+		if (::stat(path, &s) != 0)
+			return {};
+
+		File_Info self = {};
+		self.exists = true;
+		self.size = (u64)s.st_size;
+		self.modified_ns = (i64)s.st_mtim.tv_sec * 1000000000ll + s.st_mtim.tv_nsec;
+		return self;
+	}
 }
 
 #endif
@@ -0,0 +1,176 @@
+#if REX_OS_LINUX
+
+#include "rex-core/thread.h"
+#include "rex-core/memory.h"
+#include "rex-core/assert.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+namespace rc
+{
+	static constexpr u32 THREAD_POOL_MAX_WORKERS = 64;
+
+	struct Thread_Pool_Worker
+	{
+		Thread_Pool* pool;
+		pthread_t handle;
+		u32 index;
+	};
+
+	struct Thread_Pool
+	{
+		Thread_Pool_Worker workers[THREAD_POOL_MAX_WORKERS];
+		u32 workers_count;
+
+		pthread_mutex_t mutex;
+		pthread_cond_t work_cond;
+		pthread_cond_t done_cond;
+
+		// current job, guarded by the mutex except for next which workers claim atomically
+		task_proc_t proc;
+		void* user_data;
+		u32 count;
+		u32 next;
+		u32 busy;
+		u64 generation;
+		bool quit;
+	};
+
+	inline static void
+	_thread_pool_drain(Thread_Pool* self, task_proc_t proc, void* user_data, u32 count, u32 worker)
+	{
+		for (;;)
+		{
+			auto index = __atomic_fetch_add(&self->next, 1u, __ATOMIC_RELAXED);
+			if (index >= count)
+				break;
+			proc(user_data, index, worker);
+		}
+	}
+
+	static void*
+	_thread_pool_worker_main(void* user_data)
+	{
+		auto worker = (Thread_Pool_Worker*)user_data;
+		auto self = worker->pool;
+		u64 generation = 0;
+
+		pthread_mutex_lock(&self->mutex);
+		for (;;)
+		{
+			while (self->quit == false && self->generation == generation)
+				pthread_cond_wait(&self->work_cond, &self->mutex);
+
+			if (self->quit)
+				break;
+
+			generation = self->generation;
+			auto proc = self->proc;
+			auto job_user_data = self->user_data;
+			auto count = self->count;
+			pthread_mutex_unlock(&self->mutex);
+
+			_thread_pool_drain(self, proc, job_user_data, count, worker->index);
+
+			pthread_mutex_lock(&self->mutex);
+			if (--self->busy == 0)
+				pthread_cond_signal(&self->done_cond);
+		}
+		pthread_mutex_unlock(&self->mutex);
+
+		return nullptr;
+	}
+
+	u32
+	thread_cores_count()
+	{
+		auto count = ::sysconf(_SC_NPROCESSORS_ONLN);
+		return count > 0 ? (u32)count : 1;
+	}
+
+	Thread_Pool*
+	thread_pool_init(u32 workers_count)
+	{
+		if (workers_count == 0)
+			workers_count = thread_cores_count();
+		if (workers_count > THREAD_POOL_MAX_WORKERS)
+			workers_count = THREAD_POOL_MAX_WORKERS;
+
+		auto self = rex_alloc_zeroed_T(Thread_Pool);
+		self->workers_count = workers_count;
+
+		pthread_mutex_init(&self->mutex, nullptr);
+		pthread_cond_init(&self->work_cond, nullptr);
+		pthread_cond_init(&self->done_cond, nullptr);
+
+		// worker 0 is the calling thread
+		for (u32 i = 1; i < workers_count; ++i)
+		{
+			auto worker = &self->workers[i];
+			worker->pool = self;
+			worker->index = i;
+			auto res = pthread_create(&worker->handle, nullptr, _thread_pool_worker_main, worker);
+			rex_assert_msg(res == 0, "[rex-core]: failed to create worker thread");
+		}
+
+		return self;
+	}
+
+	void
+	thread_pool_deinit(Thread_Pool* self)
+	{
+		if (self == nullptr)
+			return;
+
+		pthread_mutex_lock(&self->mutex);
+		self->quit = true;
+		pthread_cond_broadcast(&self->work_cond);
+		pthread_mutex_unlock(&self->mutex);
+
+		for (u32 i = 1; i < self->workers_count; ++i)
+			pthread_join(self->workers[i].handle, nullptr);
+
+		pthread_cond_destroy(&self->done_cond);
+		pthread_cond_destroy(&self->work_cond);
+		pthread_mutex_destroy(&self->mutex);
+
+		rex_dealloc(self);
+	}
+
+	u32
+	thread_pool_workers_count(const Thread_Pool* self)
+	{
+		return self->workers_count;
+	}
+
+	void
+	thread_pool_run(Thread_Pool* self, u32 count, task_proc_t proc, void* user_data)
+	{
+		if (self->workers_count == 1 || count <= 1)
+		{
+			for (u32 i = 0; i < count; ++i)
+				proc(user_data, i, 0);
+			return;
+		}
+
+		pthread_mutex_lock(&self->mutex);
+		self->proc = proc;
+		self->user_data = user_data;
+		self->count = count;
+		self->next = 0;
+		self->busy = self->workers_count - 1;
+		self->generation++;
+		pthread_cond_broadcast(&self->work_cond);
+		pthread_mutex_unlock(&self->mutex);
+
+		_thread_pool_drain(self, proc, user_data, count, 0);
+
+		pthread_mutex_lock(&self->mutex);
+		while (self->busy > 0)
+			pthread_cond_wait(&self->done_cond, &self->mutex);
+		pthread_mutex_unlock(&self->mutex);
+	}
+}
+
+#endif
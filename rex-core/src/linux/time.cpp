@@ -30,6 +30,14 @@ namespace rc
 		return milliseconds;
 	}
 
+	u64
+	time_nanoseconds()
+	{
+		struct timespec now;
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		return (u64)now.tv_sec * 1'000'000'000 + (u64)now.tv_nsec;
+	}
+
 	void
 	sleep(u32 milliseconds)
 	{
@@ -13,8 +13,12 @@
 #include <xcb/xcb_atom.h>
 #include <xcb/xcb_keysyms.h>
 #include <xcb/xcb_image.h>
+#include <xcb/shm.h>
 #include <X11/keysym.h>
 #include <stdlib.h>
+#include <string.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
 
 namespace rc
 {
@@ -27,6 +31,22 @@ namespace rc
 		xcb_window_t handle;
 		xcb_atom_t wm_delete_win;
 		xcb_key_symbols_t *key_symbols;
+
+		// MIT-SHM presentation, the server reads the pixels straight from shared memory instead of
+		// receiving them over the socket. segments are double buffered, each one keeps a round trip
+		// request issued right after its put image, once it is answered the server is done with it
+		bool shm_available;
+		xcb_gcontext_t shm_gc;
+		struct
+		{
+			xcb_shm_seg_t handle;
+			int id;
+			uint32_t* pixels;
+			i32 width, height;
+			bool fence_pending;
+			xcb_get_input_focus_cookie_t fence;
+		} shm[2];
+		int shm_index;
 	};
 
 	// internal function that map between xcb_keycode_t and MP_KEY enum
@@ -84,6 +104,82 @@ namespace rc
 		return KEY_NONE;
 	}
 
+	// waits until the server is done reading the segment
+	static void
+	_shm_segment_wait(IWindow* self, int index)
+	{
+		auto& segment = self->shm[index];
+		if (segment.fence_pending == false)
+			return;
+
+		free(xcb_get_input_focus_reply(self->connection, segment.fence, nullptr));
+		segment.fence_pending = false;
+	}
+
+	static void
+	_shm_segment_free(IWindow* self, int index)
+	{
+		auto& segment = self->shm[index];
+		if (segment.pixels == nullptr)
+			return;
+
+		_shm_segment_wait(self, index);
+		xcb_shm_detach(self->connection, segment.handle);
+		shmdt(segment.pixels);
+		segment.pixels = nullptr;
+		segment.width = 0;
+		segment.height = 0;
+	}
+
+	// (re)creates the segment to fit the frame, disables shm presentation if the server can't attach it
+	// (e.g. a remote display)
+	static bool
+	_shm_segment_fit(IWindow* self, int index, i32 width, i32 height)
+	{
+		auto& segment = self->shm[index];
+		if (segment.pixels && segment.width == width && segment.height == height)
+			return true;
+
+		_shm_segment_free(self, index);
+
+		auto id = shmget(IPC_PRIVATE, (size_t)width * (size_t)height * sizeof(uint32_t), IPC_CREAT | 0600);
+		if (id == -1)
+		{
+			self->shm_available = false;
+			return false;
+		}
+
+		auto pixels = shmat(id, nullptr, 0);
+		if (pixels == (void*)-1)
+		{
+			shmctl(id, IPC_RMID, nullptr);
+			self->shm_available = false;
+			return false;
+		}
+
+		auto handle = xcb_generate_id(self->connection);
+		auto error = xcb_request_check(self->connection, xcb_shm_attach_checked(self->connection, handle, id, 0));
+
+		// the segment is destroyed once both sides detach, even if we crash
+		shmctl(id, IPC_RMID, nullptr);
+
+		if (error)
+		{
+			free(error);
+			shmdt(pixels);
+			self->shm_available = false;
+			return false;
+		}
+
+		segment.handle = handle;
+		segment.id = id;
+		segment.pixels = (uint32_t*)pixels;
+		segment.width = width;
+		segment.height = height;
+		segment.fence_pending = false;
+		return true;
+	}
+
 	Window *
 	window_init(const char *title, i32 width, i32 height, void* user_data, event_callback_t event_callback)
 	{
@@ -189,6 +285,24 @@ namespace rc
 			return nullptr;
 		}
 
+		// shm presentation is optional, window_blit falls back to sending the pixels over the socket
+		auto shm_extension = xcb_get_extension_data(self->connection, &xcb_shm_id);
+		if (shm_extension && shm_extension->present)
+		{
+			auto reply = xcb_shm_query_version_reply(self->connection, xcb_shm_query_version(self->connection), nullptr);
+			if (reply)
+			{
+				self->shm_available = true;
+				free(reply);
+			}
+		}
+
+		if (self->shm_available)
+		{
+			self->shm_gc = xcb_generate_id(self->connection);
+			xcb_create_gc(self->connection, self->shm_gc, self->handle, 0, nullptr);
+		}
+
 		return &self->window;
 	}
 
@@ -197,6 +311,11 @@ namespace rc
 	{
 		auto self = (IWindow *)window;
 
+		_shm_segment_free(self, 0);
+		_shm_segment_free(self, 1);
+		if (self->shm_gc)
+			xcb_free_gc(self->connection, self->shm_gc);
+
 		free(self->key_symbols);
 		xcb_destroy_window(self->connection, self->handle);
 		xcb_disconnect(self->connection);
@@ -353,11 +472,64 @@ namespace rc
 		);
 	}
 
+	uint32_t*
+	window_back_buffer(Window* window, i32 width, i32 height)
+	{
+		auto self = (IWindow *)window;
+
+		if (self->shm_available == false || width <= 0 || height <= 0)
+			return nullptr;
+
+		auto index = self->shm_index;
+		if (_shm_segment_fit(self, index, width, height) == false)
+			return nullptr;
+
+		_shm_segment_wait(self, index);
+		return self->shm[index].pixels;
+	}
+
 	void
 	window_blit(Window* window, uint32_t* pixels, i32 width, i32 height)
 	{
 		auto self = (IWindow *)window;
 
+		if (self->shm_available && width > 0 && height > 0)
+		{
+			// pixels rendered into the back buffer are presented as is, anything else is copied into it
+			auto index = self->shm_index;
+			auto& segment = self->shm[index];
+			if (pixels != segment.pixels || segment.width != width || segment.height != height)
+			{
+				auto back_buffer = window_back_buffer(window, width, height);
+				if (back_buffer)
+					::memcpy(back_buffer, pixels, (size_t)width * (size_t)height * sizeof(uint32_t));
+			}
+
+			if (self->shm_available)
+			{
+				xcb_shm_put_image(
+					self->connection,
+					self->handle,
+					self->shm_gc,
+					width, height,                // total size
+					0, 0,                         // source position
+					width, height,                // source size
+					0, 0,                         // destination position
+					self->screen->root_depth,
+					XCB_IMAGE_FORMAT_Z_PIXMAP,
+					0,                            // no completion event, we fence with a round trip
+					segment.handle,
+					0
+				);
+				segment.fence = xcb_get_input_focus(self->connection);
+				segment.fence_pending = true;
+				xcb_flush(self->connection);
+
+				self->shm_index = (index + 1) % 2;
+				return;
+			}
+		}
+
 		auto pixmap = xcb_generate_id(self->connection);
 		xcb_create_pixmap(
 			self->connection,
@@ -144,7 +144,7 @@ namespace rc
 			return;
 
 		clear();
-		printf("[rex-core]: Frame allocator initial capacity: %zu bytes and peak: %zu bytes\n",
+		fprintf(stderr, "[rex-core]: Frame allocator initial capacity: %zu bytes and peak: %zu bytes\n",
 			FRAME_ALLOCATOR_INITIAL_CAPACITY, peak_size);
 		rex_dealloc(head);
 	}
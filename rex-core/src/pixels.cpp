@@ -0,0 +1,59 @@
+#include "rex-core/pixels.h"
+#include "rex-core/cpu.h"
+
+#include "pixels_kernels.h"
+
+namespace rc
+{
+	struct _Pixels_Kernels
+	{
+		void (*u8_to_f32)(const u8* src, f32* dst, sz count);
+		void (*f32_to_u8)(const f32* src, u8* dst, sz count);
+		void (*swizzle_rb)(const u32* src, u32* dst, sz count);
+		void (*premultiply)(const u32* src, u32* dst, sz count);
+	};
+
+	inline static _Pixels_Kernels
+	_pixels_kernels_query()
+	{
+	#if REX_ARCH_X86
+		auto features = cpu_features();
+		if (features.avx2)
+			return _Pixels_Kernels{_pixels_u8_to_f32_avx2, _pixels_f32_to_u8_avx2, _pixels_swizzle_rb_avx2, _pixels_premultiply_avx2};
+		if (features.sse41)
+			return _Pixels_Kernels{_pixels_u8_to_f32_sse4, _pixels_f32_to_u8_sse4, _pixels_swizzle_rb_sse4, _pixels_premultiply_sse4};
+	#endif
+		return _Pixels_Kernels{_pixels_u8_to_f32_scalar, _pixels_f32_to_u8_scalar, _pixels_swizzle_rb_scalar, _pixels_premultiply_scalar};
+	}
+
+	inline static const _Pixels_Kernels&
+	_pixels_kernels()
+	{
+		static _Pixels_Kernels self = _pixels_kernels_query();
+		return self;
+	}
+
+	void
+	pixels_u8_to_f32(const u8* src, f32* dst, sz count)
+	{
+		_pixels_kernels().u8_to_f32(src, dst, count);
+	}
+
+	void
+	pixels_f32_to_u8(const f32* src, u8* dst, sz count)
+	{
+		_pixels_kernels().f32_to_u8(src, dst, count);
+	}
+
+	void
+	pixels_swizzle_rb(const u32* src, u32* dst, sz count)
+	{
+		_pixels_kernels().swizzle_rb(src, dst, count);
+	}
+
+	void
+	pixels_premultiply(const u32* src, u32* dst, sz count)
+	{
+		_pixels_kernels().premultiply(src, dst, count);
+	}
+}
@@ -0,0 +1,104 @@
+#if REX_ARCH_X86
+
+#include "pixels_kernels.h"
+
+#include <immintrin.h>
+
+namespace rc
+{
+	inline static __m256i
+	_load(const void* ptr)
+	{
+		return _mm256_loadu_si256((const __m256i*)ptr);
+	}
+
+	inline static void
+	_store(void* ptr, __m256i value)
+	{
+		_mm256_storeu_si256((__m256i*)ptr, value);
+	}
+
+	// 32 channels per iteration
+	void
+	_pixels_u8_to_f32_avx2(const u8* src, f32* dst, sz count)
+	{
+		auto scale = _mm256_set1_ps(255.0f);
+		sz i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			for (int k = 0; k < 4; ++k)
+			{
+				auto bytes = _mm_loadl_epi64((const __m128i*)(const void*)(src + i + k * 8));
+				auto c = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(bytes));
+				_mm256_storeu_ps(dst + i + k * 8, _mm256_div_ps(c, scale));
+			}
+		}
+		_pixels_u8_to_f32_scalar(src + i, dst + i, count - i);
+	}
+
+	// 32 channels per iteration, the packs work inside 128-bit lanes so the result comes out as 4 byte
+	// groups in the order 0 2 4 6 1 3 5 7 and a permute puts them back
+	void
+	_pixels_f32_to_u8_avx2(const f32* src, u8* dst, sz count)
+	{
+		auto zero = _mm256_setzero_ps();
+		auto one = _mm256_set1_ps(1.0f);
+		auto scale = _mm256_set1_ps(255.0f);
+		auto order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+		sz i = 0;
+		for (; i + 32 <= count; i += 32)
+		{
+			__m256i c[4];
+			for (int k = 0; k < 4; ++k)
+			{
+				auto f = _mm256_min_ps(_mm256_max_ps(_mm256_loadu_ps(src + i + k * 8), zero), one);
+				c[k] = _mm256_cvttps_epi32(_mm256_mul_ps(f, scale));
+			}
+			auto packed = _mm256_packus_epi16(_mm256_packs_epi32(c[0], c[1]), _mm256_packs_epi32(c[2], c[3]));
+			_store(dst + i, _mm256_permutevar8x32_epi32(packed, order));
+		}
+		_pixels_f32_to_u8_scalar(src + i, dst + i, count - i);
+	}
+
+	// 8 pixels per iteration
+	void
+	_pixels_swizzle_rb_avx2(const u32* src, u32* dst, sz count)
+	{
+		auto order = _mm256_setr_epi8(
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+			2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15
+		);
+		sz i = 0;
+		for (; i + 8 <= count; i += 8)
+			_store(dst + i, _mm256_shuffle_epi8(_load(src + i), order));
+		_pixels_swizzle_rb_scalar(src + i, dst + i, count - i);
+	}
+
+	// 2 pixels per 16-bit half of each lane, alpha times itself is thrown away for the original alpha bytes
+	inline static __m256i
+	_premultiply_half(__m256i c)
+	{
+		auto a = _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(c, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		auto t = _mm256_add_epi16(_mm256_mullo_epi16(c, a), _mm256_set1_epi16(128));
+		return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+	}
+
+	// 8 pixels per iteration, the unpacks and the pack are all inside 128-bit lanes so the order holds
+	void
+	_pixels_premultiply_avx2(const u32* src, u32* dst, sz count)
+	{
+		auto zero = _mm256_setzero_si256();
+		auto alpha = _mm256_set1_epi32((int)0xFF000000);
+		sz i = 0;
+		for (; i + 8 <= count; i += 8)
+		{
+			auto p = _load(src + i);
+			auto lo = _premultiply_half(_mm256_unpacklo_epi8(p, zero));
+			auto hi = _premultiply_half(_mm256_unpackhi_epi8(p, zero));
+			_store(dst + i, _mm256_blendv_epi8(_mm256_packus_epi16(lo, hi), p, alpha));
+		}
+		_pixels_premultiply_scalar(src + i, dst + i, count - i);
+	}
+}
+
+#endif
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "rex-core/types.h"
+
+// the scalar kernels are the reference, the simd ones convert the bulk of a buffer and finish the tail
+// with these so every variant gives the same bytes
+
+namespace rc
+{
+	inline static void
+	_pixels_u8_to_f32_scalar(const u8* src, f32* dst, sz count)
+	{
+		for (sz i = 0; i < count; ++i)
+			dst[i] = (f32)src[i] / 255.0f;
+	}
+
+	inline static void
+	_pixels_f32_to_u8_scalar(const f32* src, u8* dst, sz count)
+	{
+		for (sz i = 0; i < count; ++i)
+		{
+			auto c = src[i];
+			c = c > 0.0f ? (c < 1.0f ? c : 1.0f) : 0.0f;
+			dst[i] = (u8)(c * 255.0f);
+		}
+	}
+
+	inline static void
+	_pixels_swizzle_rb_scalar(const u32* src, u32* dst, sz count)
+	{
+		for (sz i = 0; i < count; ++i)
+		{
+			auto p = src[i];
+			dst[i] = (p & 0xFF00FF00u) | ((p >> 16) & 0xFFu) | ((p & 0xFFu) << 16);
+		}
+	}
+
+	// (c * a + 128 + ((c * a + 128) >> 8)) >> 8 is c * a / 255 rounded for any 8-bit c and a
+	inline static u32
+	_pixel_premultiply_channel(u32 c, u32 a)
+	{
+		auto t = c * a + 128;
+		return (t + (t >> 8)) >> 8;
+	}
+
+	inline static void
+	_pixels_premultiply_scalar(const u32* src, u32* dst, sz count)
+	{
+		for (sz i = 0; i < count; ++i)
+		{
+			auto p = src[i];
+			auto a = p >> 24;
+			dst[i] =
+				_pixel_premultiply_channel(p & 0xFF, a) |
+				(_pixel_premultiply_channel((p >> 8) & 0xFF, a) << 8) |
+				(_pixel_premultiply_channel((p >> 16) & 0xFF, a) << 16) |
+				(a << 24);
+		}
+	}
+
+#if REX_ARCH_X86
+	// compiled with -msse4.1
+	void _pixels_u8_to_f32_sse4(const u8* src, f32* dst, sz count);
+	void _pixels_f32_to_u8_sse4(const f32* src, u8* dst, sz count);
+	void _pixels_swizzle_rb_sse4(const u32* src, u32* dst, sz count);
+	void _pixels_premultiply_sse4(const u32* src, u32* dst, sz count);
+
+	// compiled with -mavx2
+	void _pixels_u8_to_f32_avx2(const u8* src, f32* dst, sz count);
+	void _pixels_f32_to_u8_avx2(const f32* src, u8* dst, sz count);
+	void _pixels_swizzle_rb_avx2(const u32* src, u32* dst, sz count);
+	void _pixels_premultiply_avx2(const u32* src, u32* dst, sz count);
+#endif
+}
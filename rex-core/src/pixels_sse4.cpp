@@ -0,0 +1,99 @@
+#if REX_ARCH_X86
+
+#include "pixels_kernels.h"
+
+#include <smmintrin.h>
+
+namespace rc
+{
+	inline static __m128i
+	_load(const void* ptr)
+	{
+		return _mm_loadu_si128((const __m128i*)ptr);
+	}
+
+	inline static void
+	_store(void* ptr, __m128i value)
+	{
+		_mm_storeu_si128((__m128i*)ptr, value);
+	}
+
+	// 16 channels per iteration
+	void
+	_pixels_u8_to_f32_sse4(const u8* src, f32* dst, sz count)
+	{
+		auto scale = _mm_set1_ps(255.0f);
+		sz i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			auto bytes = _load(src + i);
+			for (int k = 0; k < 4; ++k)
+			{
+				auto c = _mm_cvtepi32_ps(_mm_cvtepu8_epi32(bytes));
+				_mm_storeu_ps(dst + i + k * 4, _mm_div_ps(c, scale));
+				bytes = _mm_srli_si128(bytes, 4);
+			}
+		}
+		_pixels_u8_to_f32_scalar(src + i, dst + i, count - i);
+	}
+
+	// 16 channels per iteration, max returns its second operand for nan so nan clamps to 0
+	void
+	_pixels_f32_to_u8_sse4(const f32* src, u8* dst, sz count)
+	{
+		auto zero = _mm_setzero_ps();
+		auto one = _mm_set1_ps(1.0f);
+		auto scale = _mm_set1_ps(255.0f);
+		sz i = 0;
+		for (; i + 16 <= count; i += 16)
+		{
+			__m128i c[4];
+			for (int k = 0; k < 4; ++k)
+			{
+				auto f = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(src + i + k * 4), zero), one);
+				c[k] = _mm_cvttps_epi32(_mm_mul_ps(f, scale));
+			}
+			_store(dst + i, _mm_packus_epi16(_mm_packs_epi32(c[0], c[1]), _mm_packs_epi32(c[2], c[3])));
+		}
+		_pixels_f32_to_u8_scalar(src + i, dst + i, count - i);
+	}
+
+	// 4 pixels per iteration
+	void
+	_pixels_swizzle_rb_sse4(const u32* src, u32* dst, sz count)
+	{
+		auto order = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+		sz i = 0;
+		for (; i + 4 <= count; i += 4)
+			_store(dst + i, _mm_shuffle_epi8(_load(src + i), order));
+		_pixels_swizzle_rb_scalar(src + i, dst + i, count - i);
+	}
+
+	// 2 pixels per 16-bit half, alpha times itself is thrown away for the original alpha bytes
+	inline static __m128i
+	_premultiply_half(__m128i c)
+	{
+		auto a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+		auto t = _mm_add_epi16(_mm_mullo_epi16(c, a), _mm_set1_epi16(128));
+		return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+	}
+
+	// 4 pixels per iteration
+	void
+	_pixels_premultiply_sse4(const u32* src, u32* dst, sz count)
+	{
+		auto zero = _mm_setzero_si128();
+		auto alpha = _mm_set1_epi32((int)0xFF000000);
+		sz i = 0;
+		for (; i + 4 <= count; i += 4)
+		{
+			auto p = _load(src + i);
+			auto lo = _premultiply_half(_mm_unpacklo_epi8(p, zero));
+			auto hi = _premultiply_half(_mm_unpackhi_epi8(p, zero));
+			_store(dst + i, _mm_blendv_epi8(_mm_packus_epi16(lo, hi), p, alpha));
+		}
+		_pixels_premultiply_scalar(src + i, dst + i, count - i);
+	}
+}
+
+#endif
@@ -0,0 +1,179 @@
+#include "rex-core/profile.h"
+#include "rex-core/log.h"
+
+#include <atomic>
+#include <stdio.h>
+#include <stdlib.h>
+
+namespace rc
+{
+	struct Profile_Event
+	{
+		const char* name;
+		u64 start_ns;
+		u64 end_ns;
+	};
+
+	// only the owning thread writes to its buffer
+	struct Profile_Thread
+	{
+		Profile_Event events[PROFILE_THREAD_EVENTS];
+		u64 count;
+		u32 id;
+	};
+
+	struct _Profiler
+	{
+		std::atomic<bool> enabled;
+		std::atomic<u32> threads_count;
+		Profile_Thread* threads[PROFILE_MAX_THREADS];
+
+		u64 frames[PROFILE_MAX_FRAMES];
+		u64 frames_count;
+
+		~_Profiler()
+		{
+			auto count = threads_count.load();
+			for (u32 i = 0; i < count && i < PROFILE_MAX_THREADS; ++i)
+				::free(threads[i]);
+		}
+	};
+
+	static _Profiler _profiler;
+	static thread_local Profile_Thread* _profile_thread;
+	static thread_local bool _profile_thread_full;
+
+	// the rex allocator isn't thread safe and the buffers are created on the first zone of every thread
+	inline static Profile_Thread*
+	_profile_thread_get()
+	{
+		if (_profile_thread || _profile_thread_full)
+			return _profile_thread;
+
+		auto id = _profiler.threads_count.fetch_add(1);
+		if (id >= PROFILE_MAX_THREADS)
+		{
+			_profile_thread_full = true;
+			return nullptr;
+		}
+
+		auto self = (Profile_Thread*)::calloc(1, sizeof(Profile_Thread));
+		self->id = id;
+		_profiler.threads[id] = self;
+		_profile_thread = self;
+		return self;
+	}
+
+	void
+	profile_enable(bool enabled)
+	{
+		_profiler.enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	bool
+	profile_enabled()
+	{
+		return _profiler.enabled.load(std::memory_order_relaxed);
+	}
+
+	void
+	profile_zone_record(const char* name, u64 start_ns, u64 end_ns)
+	{
+		auto self = _profile_thread_get();
+		if (self == nullptr)
+			return;
+
+		self->events[self->count % PROFILE_THREAD_EVENTS] = Profile_Event{name, start_ns, end_ns};
+		++self->count;
+	}
+
+	void
+	profile_frame_mark()
+	{
+		if (profile_enabled() == false)
+			return;
+
+		_profiler.frames[_profiler.frames_count % PROFILE_MAX_FRAMES] = time_nanoseconds();
+		++_profiler.frames_count;
+	}
+
+	bool
+	profile_dump_chrome_trace(const char* path, u32 frames_count)
+	{
+		auto file = fopen(path, "wb");
+		if (file == nullptr)
+		{
+			rex_log_error("[rex-core]: failed to open profile trace file '%s'", path);
+			return false;
+		}
+
+		// window of the last complete frames, a frame runs from its mark to the next one
+		u64 begin_ns = 0, end_ns = ~0ull;
+		auto marks = _profiler.frames_count;
+		if (frames_count && marks > 1)
+		{
+			auto last = marks - 1;
+			auto oldest = marks > PROFILE_MAX_FRAMES ? marks - PROFILE_MAX_FRAMES : 0;
+			auto first = last > frames_count ? last - frames_count : 0;
+			if (first < oldest)
+				first = oldest;
+			begin_ns = _profiler.frames[first % PROFILE_MAX_FRAMES];
+			end_ns = _profiler.frames[last % PROFILE_MAX_FRAMES];
+		}
+
+		// timestamps are relative to the first mark or event so they fit in a double without losing precision
+		auto oldest_mark = marks > PROFILE_MAX_FRAMES ? marks - PROFILE_MAX_FRAMES : 0;
+		auto origin_ns = marks ? _profiler.frames[oldest_mark % PROFILE_MAX_FRAMES] : ~0ull;
+		if (origin_ns < begin_ns)
+			origin_ns = begin_ns;
+		auto threads_count = _profiler.threads_count.load();
+		if (threads_count > PROFILE_MAX_THREADS)
+			threads_count = PROFILE_MAX_THREADS;
+		for (u32 i = 0; i < threads_count; ++i)
+		{
+			auto thread = _profiler.threads[i];
+			auto first = thread->count > PROFILE_THREAD_EVENTS ? thread->count - PROFILE_THREAD_EVENTS : 0;
+			for (auto j = first; j < thread->count; ++j)
+			{
+				auto& event = thread->events[j % PROFILE_THREAD_EVENTS];
+				if (event.start_ns < end_ns && event.end_ns > begin_ns && event.start_ns < origin_ns)
+					origin_ns = event.start_ns;
+			}
+		}
+		if (origin_ns == ~0ull)
+			origin_ns = begin_ns;
+
+		fprintf(file, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+		fprintf(file, "\t{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 0, \"args\": {\"name\": \"rex\"}}");
+
+		for (u32 i = 0; i < threads_count; ++i)
+			fprintf(file, ",\n\t{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": %u, \"args\": {\"name\": \"thread %u\"}}", i, i);
+
+		for (auto i = oldest_mark; i < marks; ++i)
+		{
+			auto mark_ns = _profiler.frames[i % PROFILE_MAX_FRAMES];
+			if (mark_ns < begin_ns || mark_ns > end_ns)
+				continue;
+			fprintf(file, ",\n\t{\"name\": \"frame %llu\", \"ph\": \"i\", \"s\": \"g\", \"pid\": 0, \"tid\": 0, \"ts\": %.3f}",
+				(unsigned long long)i, (double)(i64)(mark_ns - origin_ns) * 0.001);
+		}
+
+		for (u32 i = 0; i < threads_count; ++i)
+		{
+			auto thread = _profiler.threads[i];
+			auto first = thread->count > PROFILE_THREAD_EVENTS ? thread->count - PROFILE_THREAD_EVENTS : 0;
+			for (auto j = first; j < thread->count; ++j)
+			{
+				auto& event = thread->events[j % PROFILE_THREAD_EVENTS];
+				if (event.start_ns >= end_ns || event.end_ns <= begin_ns)
+					continue;
+				fprintf(file, ",\n\t{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 0, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}",
+					event.name, thread->id, (double)(i64)(event.start_ns - origin_ns) * 0.001, (event.end_ns - event.start_ns) * 0.001);
+			}
+		}
+
+		fprintf(file, "\n]}\n");
+		fclose(file);
+		return true;
+	}
+}
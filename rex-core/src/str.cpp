@@ -1,8 +1,11 @@
 #include "rex-core/str.h"
 #include "rex-core/assert.h"
+#include "str_pow5.h"
 
 #include <cstdarg>
 #include <cstdio>
+#include <cstdlib>
+#include <cstring>
 
 namespace rc
 {
@@ -183,126 +186,500 @@ namespace rc
 		return lines;
 	}
 
-	// TODO: use Res instead of boolean pointer
-	double
-	str_to_double(const Str& self, bool* succeeded)
+	struct _U128
+	{
+		u64 low, high;
+	};
+
+	inline static _U128
+	_mul_64x64(u64 a, u64 b)
+	{
+		auto a_low = a & 0xFFFFFFFFull, a_high = a >> 32;
+		auto b_low = b & 0xFFFFFFFFull, b_high = b >> 32;
+		auto p0 = a_low * b_low;
+		auto p1 = a_low * b_high;
+		auto p2 = a_high * b_low;
+		auto p3 = a_high * b_high;
+		auto middle = (p0 >> 32) + (p1 & 0xFFFFFFFFull) + (p2 & 0xFFFFFFFFull);
+		return _U128{(middle << 32) | (p0 & 0xFFFFFFFFull), p3 + (p1 >> 32) + (p2 >> 32) + (middle >> 32)};
+	}
+
+	inline static int
+	_leading_zeros(u64 x)
+	{
+		int count = 0;
+		if ((x >> 32) == 0) { count += 32; x <<= 32; }
+		if ((x >> 48) == 0) { count += 16; x <<= 16; }
+		if ((x >> 56) == 0) { count += 8;  x <<= 8;  }
+		if ((x >> 60) == 0) { count += 4;  x <<= 4;  }
+		if ((x >> 62) == 0) { count += 2;  x <<= 2;  }
+		if ((x >> 63) == 0) { count += 1; }
+		return count;
+	}
+
+	inline static bool
+	_is_digit(char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+	// case insensitive match of a lower case word at it
+	inline static bool
+	_match_word(const char* it, const char* last, const char* word)
+	{
+		for (; *word; ++word, ++it)
+			if (it == last || (*it | 0x20) != *word)
+				return false;
+		return true;
+	}
+
+	static constexpr u64 _DOUBLE_INFINITY = 0x7FF0000000000000ull;
+	static constexpr u64 _DOUBLE_MANTISSA_BITS = 52;
+
+	// eisel-lemire: w * 10^q rounded to the nearest double as raw bits, returns false in the rare cases
+	// where the truncated 128 bit power of five can't decide the rounding, bits is then at most an ulp off
+	inline static bool
+	_eisel_lemire(u64 w, i64 q, u64* bits)
 	{
-		if (self.count == 0)
+		if (w == 0 || q < _POW5_MIN_EXPONENT)
 		{
-			*succeeded = false;
-			return 0;
+			*bits = 0;
+			return true;
+		}
+		if (q > _POW5_MAX_EXPONENT)
+		{
+			*bits = _DOUBLE_INFINITY;
+			return true;
 		}
 
-		sz i = 0;
-		int sign = 1;
-		if (self[0] == '-')
+		auto lz = _leading_zeros(w);
+		w <<= lz;
+
+		// the high 64 bits hold the 53 bits of mantissa plus a rounding bit and an extra one, the low half
+		// of the power only matters when the bits below those are all ones
+		auto index = (q - _POW5_MIN_EXPONENT) * 2;
+		auto product = _mul_64x64(w, _POW5[index]);
+		if ((product.high & 0x1FF) == 0x1FF)
+		{
+			auto second = _mul_64x64(w, _POW5[index + 1]);
+			product.low += second.high;
+			if (second.high > product.low)
+				++product.high;
+		}
+		auto decided = (product.low == ~0ull && (q < -27 || q > 55)) == false;
+
+		auto upper_bit = (int)(product.high >> 63);
+		auto shift = upper_bit + 64 - (int)_DOUBLE_MANTISSA_BITS - 3;
+		auto mantissa = product.high >> shift;
+		// floor(log2(10^q)) + 63 biased by 1023
+		auto power2 = ((217706 * q) >> 16) + 63 + upper_bit - lz + 1023;
+
+		if (power2 <= 0)
 		{
-			if (self.count == 1)
+			// subnormal, ties can't happen this far from 1
+			if (-power2 + 1 >= 64)
 			{
-				*succeeded = false;
-				return 0;
+				*bits = 0;
+				return true;
 			}
+			mantissa >>= -power2 + 1;
+			mantissa += mantissa & 1;
+			mantissa >>= 1;
+			*bits = mantissa;
+			return decided;
+		}
+
+		// exactly halfway between two doubles, only possible for small exponents, round to even
+		if (product.low <= 1 && q >= -4 && q <= 23 && (mantissa & 3) == 1 && (mantissa << shift) == product.high)
+			mantissa &= ~1ull;
 
-			sign = -1;
-			i = 1;
+		mantissa += mantissa & 1;
+		mantissa >>= 1;
+		if (mantissa >= (2ull << _DOUBLE_MANTISSA_BITS))
+		{
+			mantissa = 1ull << _DOUBLE_MANTISSA_BITS;
+			++power2;
 		}
+		mantissa &= ~(1ull << _DOUBLE_MANTISSA_BITS);
 
-		double value = 0.0;
-		double multiplier = 10.0;
-		for (; i < self.count; ++i)
+		if (power2 >= 0x7FF)
+		{
+			*bits = _DOUBLE_INFINITY;
+			return decided;
+		}
+
+		*bits = ((u64)power2 << _DOUBLE_MANTISSA_BITS) | mantissa;
+		return decided;
+	}
+
+	// big unsigned integer for the exact slow path, wide enough for 768 digits times the largest power of
+	// five the comparison needs
+	static constexpr int _BIG_LIMBS = 128;
+
+	struct _Big
+	{
+		u32 limbs[_BIG_LIMBS];
+		int count;
+	};
+
+	inline static void
+	_big_mul_add(_Big& self, u32 factor, u32 add)
+	{
+		u64 carry = add;
+		for (int i = 0; i < self.count; ++i)
+		{
+			auto v = (u64)self.limbs[i] * factor + carry;
+			self.limbs[i] = (u32)v;
+			carry = v >> 32;
+		}
+		if (carry)
+		{
+			rex_assert(self.count < _BIG_LIMBS);
+			self.limbs[self.count++] = (u32)carry;
+		}
+	}
+
+	inline static void
+	_big_mul_pow5(_Big& self, i64 n)
+	{
+		// 5^13 is the largest power of five in 32-bit
+		static constexpr u32 POW5[] = {1, 5, 25, 125, 625, 3125, 15625, 78125, 390625, 1953125, 9765625, 48828125, 244140625, 1220703125};
+		for (; n >= 13; n -= 13)
+			_big_mul_add(self, POW5[13], 0);
+		if (n > 0)
+			_big_mul_add(self, POW5[n], 0);
+	}
+
+	inline static void
+	_big_shift_left(_Big& self, i64 n)
+	{
+		if (self.count == 0 || n == 0)
+			return;
+
+		auto words = (int)(n / 32), bits = (int)(n % 32);
+		rex_assert(self.count + words + 1 <= _BIG_LIMBS);
+		self.limbs[self.count] = 0;
+		for (int i = self.count; i >= 0; --i)
+		{
+			auto v = (u64)self.limbs[i] << bits;
+			auto lower = i > 0 ? ((u64)self.limbs[i - 1] << bits) >> 32 : 0;
+			self.limbs[i + words] = (u32)v | (u32)lower;
+		}
+		for (int i = 0; i < words; ++i)
+			self.limbs[i] = 0;
+		self.count += words + 1;
+		while (self.count > 0 && self.limbs[self.count - 1] == 0)
+			--self.count;
+	}
+
+	inline static int
+	_big_compare(const _Big& a, const _Big& b)
+	{
+		if (a.count != b.count)
+			return a.count < b.count ? -1 : 1;
+		for (int i = a.count - 1; i >= 0; --i)
+			if (a.limbs[i] != b.limbs[i])
+				return a.limbs[i] < b.limbs[i] ? -1 : 1;
+		return 0;
+	}
+
+	// the significant digits of a decimal number, the halfway point between two doubles has at most 767
+	// of them so digits past 768 only break exact ties, sticky is set when any of those isn't zero
+	struct _Decimal
+	{
+		_Big digits;
+		i64 exponent;
+		bool sticky;
+	};
+
+	// sign of digits * 10^exponent minus the point halfway between the double bits and the next one up
+	inline static int
+	_decimal_compare_halfway(const _Decimal& self, u64 bits)
+	{
+		auto biased = (i64)(bits >> _DOUBLE_MANTISSA_BITS);
+		auto m = bits & ((1ull << _DOUBLE_MANTISSA_BITS) - 1);
+		auto e2 = biased == 0 ? (i64)-1074 : biased - 1075;
+		if (biased != 0)
+			m |= 1ull << _DOUBLE_MANTISSA_BITS;
+
+		// digits * 5^e * 2^e against (2m + 1) * 2^(e2 - 1), the powers move to whichever side keeps them
+		// positive
+		auto half = 2 * m + 1;
+		_Big lhs = self.digits;
+		_Big rhs = {};
+		rhs.limbs[0] = (u32)half;
+		rhs.limbs[1] = (u32)(half >> 32);
+		rhs.count = rhs.limbs[1] ? 2 : 1;
+
+		if (self.exponent >= 0)
+			_big_mul_pow5(lhs, self.exponent);
+		else
+			_big_mul_pow5(rhs, -self.exponent);
+
+		auto shift = self.exponent - (e2 - 1);
+		if (shift >= 0)
+			_big_shift_left(lhs, shift);
+		else
+			_big_shift_left(rhs, -shift);
+
+		auto result = _big_compare(lhs, rhs);
+		return result == 0 && self.sticky ? 1 : result;
+	}
+
+	// correctly rounded digits of [first, last) times 10^exponent, mantissa digits and an optional '.'
+	// only, starting from a candidate at most a few ulps away. exact integer arithmetic so the result
+	// doesn't depend on the c library or its locale
+	inline static u64
+	_decimal_round(const char* first, const char* last, i64 exponent, u64 bits)
+	{
+		static constexpr int MAX_DIGITS = 768;
+
+		_Decimal self = {};
+		self.exponent = exponent;
+		int count = 0;
+		bool fraction = false;
+		// digits are added 9 at a time
+		u32 chunk = 0, chunk_scale = 1;
+		for (auto it = first; it < last; ++it)
 		{
-			if (self[i] == '.')
+			if (*it == '.')
 			{
-				multiplier = 1.0 / multiplier;
+				fraction = true;
 				continue;
 			}
-			else if (self[i] == 'e')
+
+			auto digit = (u32)(*it - '0');
+			if (count == 0 && digit == 0)
 			{
-				bool result = false;
-				auto exp = str_to_int(rc::str_from(self.ptr + i + 1, self.ptr + self.count, frame_allocator()), &result);
-				if (result == false)
-				{
-					*succeeded = false;
-					return 0;
-				}
+				self.exponent -= fraction ? 1 : 0;
+				continue;
+			}
 
-				if (exp < 0)
-				{
-					for (auto i = exp; i < 0; ++i)
-						value *= 0.1;
-				}
-				else if (exp > 0)
+			if (count < MAX_DIGITS)
+			{
+				chunk = chunk * 10 + digit;
+				chunk_scale *= 10;
+				if (chunk_scale == 1000000000)
 				{
-					for (auto i = 0; i < exp; ++i)
-						value *= 10;
+					_big_mul_add(self.digits, chunk_scale, chunk);
+					chunk = 0;
+					chunk_scale = 1;
 				}
-				break;
+				++count;
+				self.exponent -= fraction ? 1 : 0;
+			}
+			else
+			{
+				self.sticky |= digit != 0;
+				self.exponent += fraction ? 0 : 1;
 			}
-			else if (self[i] >= '0' && self[i] <= '9')
+		}
+		if (chunk_scale > 1)
+			_big_mul_add(self.digits, chunk_scale, chunk);
+
+		if (self.digits.count == 0)
+			return 0;
+
+		// step to the double whose rounding interval holds the value, ties go to the even one
+		for (;;)
+		{
+			if (bits > 0)
 			{
-				if (multiplier > 1.0)
-				{
-					value *= multiplier;
-					value += self[i] - '0';
-				}
-				else
+				auto below = _decimal_compare_halfway(self, bits - 1);
+				if (below < 0 || (below == 0 && (bits & 1)))
 				{
-					value += ((self[i] - '0') * multiplier);
-					multiplier *= (0.1);
+					--bits;
+					continue;
 				}
 			}
-			else
+			if (bits < _DOUBLE_INFINITY)
 			{
-				*succeeded = false;
-				return 0;
+				auto above = _decimal_compare_halfway(self, bits);
+				if (above > 0 || (above == 0 && (bits & 1)))
+				{
+					++bits;
+					continue;
+				}
 			}
+			return bits;
 		}
-
-		*succeeded = true;
-		return sign * value;
 	}
 
-	int64_t
-	str_to_int(const Str& self, bool* succeeded)
+	sz
+	str_parse_double(const char* first, const char* last, double* value)
 	{
-		if (self.count == 0)
+		// powers of ten a double holds exactly
+		static constexpr double POW10[] = {
+			1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+			1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+		};
+
+		auto it = first;
+		bool negative = false;
+		if (it < last && (*it == '-' || *it == '+'))
 		{
-			*succeeded = false;
-			return 0;
+			negative = *it == '-';
+			++it;
 		}
 
-		int i = 0;
-		int sign = 1;
-		if (self[0] == '-')
+		if (it < last && (*it == 'i' || *it == 'I' || *it == 'n' || *it == 'N'))
 		{
-			if (self.count == 1)
-			{
-				*succeeded = false;
+			u64 bits = 0;
+			if (_match_word(it, last, "infinity"))
+				it += 8, bits = _DOUBLE_INFINITY;
+			else if (_match_word(it, last, "inf"))
+				it += 3, bits = _DOUBLE_INFINITY;
+			else if (_match_word(it, last, "nan"))
+				it += 3, bits = 0x7FF8000000000000ull;
+			else
 				return 0;
-			}
 
-			sign = -1;
-			i = 1;
+			bits |= negative ? (1ull << 63) : 0;
+			::memcpy(value, &bits, sizeof(bits));
+			return (sz)(it - first);
 		}
 
-		int64_t value = 0;
-		int multiplier = 10;
-		for (; i < self.count; ++i)
+		// the first 19 significant digits fit in a u64, the rest only matter for rounding
+		static constexpr int MAX_DIGITS = 19;
+		u64 mantissa = 0;
+		int digits = 0;
+		i64 exponent = 0;
+		bool truncated = false;
+
+		auto integer_first = it;
+		for (; it < last && _is_digit(*it); ++it)
 		{
-			if (self[i] >= '0' && self[i] <= '9')
+			if (digits < MAX_DIGITS)
 			{
-				value *= multiplier;
-				value += self[i] - '0';
+				mantissa = mantissa * 10 + (u64)(*it - '0');
+				digits += mantissa != 0;
 			}
 			else
 			{
-				*succeeded = false;
-				return 0;
+				++exponent;
+				truncated |= *it != '0';
+			}
+		}
+		auto digits_count = it - integer_first;
+
+		if (it < last && *it == '.')
+		{
+			auto fraction_first = ++it;
+			for (; it < last && _is_digit(*it); ++it)
+			{
+				if (digits < MAX_DIGITS)
+				{
+					mantissa = mantissa * 10 + (u64)(*it - '0');
+					digits += mantissa != 0;
+					--exponent;
+				}
+				else
+				{
+					truncated |= *it != '0';
+				}
+			}
+			digits_count += it - fraction_first;
+		}
+
+		if (digits_count == 0)
+			return 0;
+		auto mantissa_last = it;
+		i64 explicit_exponent = 0;
+
+		// an exponent without digits isn't part of the number, like strtod does
+		if (it < last && (*it == 'e' || *it == 'E'))
+		{
+			auto exponent_it = it + 1;
+			bool exponent_negative = false;
+			if (exponent_it < last && (*exponent_it == '-' || *exponent_it == '+'))
+			{
+				exponent_negative = *exponent_it == '-';
+				++exponent_it;
+			}
+
+			if (exponent_it < last && _is_digit(*exponent_it))
+			{
+				// anything past the clamp is zero or infinity anyway
+				i64 exponent_value = 0;
+				for (; exponent_it < last && _is_digit(*exponent_it); ++exponent_it)
+					if (exponent_value < 100000)
+						exponent_value = exponent_value * 10 + (*exponent_it - '0');
+				explicit_exponent = exponent_negative ? -exponent_value : exponent_value;
+				exponent += explicit_exponent;
+				it = exponent_it;
 			}
 		}
 
-		*succeeded = true;
-		return sign * value;
+		double result = 0.0;
+		if (truncated == false && exponent >= -22 && exponent <= 22 && mantissa <= (1ull << 53))
+		{
+			// clinger's fast path, both operands are exact so the single operation rounds correctly
+			result = exponent < 0 ? (double)mantissa / POW10[-exponent] : (double)mantissa * POW10[exponent];
+		}
+		else
+		{
+			// with dropped digits the value is between mantissa and mantissa + 1 at this exponent, if both
+			// round to the same double so does the value
+			u64 bits = 0, bits_up = 0;
+			bool decided = _eisel_lemire(mantissa, exponent, &bits);
+			if (decided && truncated)
+				decided = _eisel_lemire(mantissa + 1, exponent, &bits_up) && bits == bits_up;
+
+			// almost never taken, compares the exact decimal against the halfway points around the candidate
+			if (decided == false)
+				bits = _decimal_round(integer_first, mantissa_last, explicit_exponent, bits);
+			::memcpy(&result, &bits, sizeof(bits));
+		}
+
+		*value = negative ? -result : result;
+		return (sz)(it - first);
+	}
+
+	sz
+	str_parse_int(const char* first, const char* last, int64_t* value)
+	{
+		auto it = first;
+		bool negative = false;
+		if (it < last && (*it == '-' || *it == '+'))
+		{
+			negative = *it == '-';
+			++it;
+		}
+
+		auto digits_first = it;
+		u64 magnitude = 0;
+		for (; it < last && _is_digit(*it); ++it)
+		{
+			auto digit = (u64)(*it - '0');
+			if (magnitude > (1ull << 63) / 10 || magnitude * 10 > (1ull << 63) - digit)
+				return 0;
+			magnitude = magnitude * 10 + digit;
+		}
+
+		if (it == digits_first || (negative == false && magnitude > (u64)I64_MAX))
+			return 0;
+
+		*value = negative ? -(int64_t)(magnitude - 1) - 1 : (int64_t)magnitude;
+		return (sz)(it - first);
+	}
+
+	// TODO: use Res instead of boolean pointer
+	double
+	str_to_double(const Str& self, bool* succeeded)
+	{
+		double value = 0.0;
+		auto count = str_parse_double(self.ptr, self.ptr + self.count, &value);
+		*succeeded = count != 0 && count == self.count;
+		return *succeeded ? value : 0.0;
+	}
+
+	int64_t
+	str_to_int(const Str& self, bool* succeeded)
+	{
+		int64_t value = 0;
+		auto count = str_parse_int(self.ptr, self.ptr + self.count, &value);
+		*succeeded = count != 0 && count == self.count;
+		return *succeeded ? value : 0;
 	}
 
 	bool
@@ -33,6 +33,43 @@ namespace rc
 
 		return res;
 	}
+
+	// no mmap on the emscripten file system, the view owns a copy of the file instead
+	File_Map
+	file_map(const char* path)
+	{
+		auto content = file_read(str_lit(path));
+		if (content.ptr == nullptr)
+			return {};
+
+		File_Map self = {};
+		self.ptr = content.ptr;
+		self.count = content.count;
+		self.handle = content.ptr;
+		return self;
+	}
+
+	void
+	file_unmap(File_Map& self)
+	{
+		if (self.handle)
+			rex_dealloc(self.handle);
+		self = {};
+	}
+
+	File_Info
+	file_info(const char* path)
+	{
+		struct stat s = {};
+		if (::stat(path, &s) != 0)
+			return {};
+
+		File_Info self = {};
+		self.exists = true;
+		self.size = (u64)s.st_size;
+		self.modified_ns = (i64)s.st_mtime * 1000000000ll;
+		return self;
+	}
 }
 
 #endif
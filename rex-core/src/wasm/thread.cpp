@@ -0,0 +1,48 @@
+#if REX_OS_WASM
+
+#include "rex-core/thread.h"
+#include "rex-core/memory.h"
+
+namespace rc
+{
+	// TODO: use web workers, for now we build without pthreads support so everything runs on the main thread
+	struct Thread_Pool
+	{
+		u32 workers_count;
+	};
+
+	u32
+	thread_cores_count()
+	{
+		return 1;
+	}
+
+	Thread_Pool*
+	thread_pool_init(u32)
+	{
+		auto self = rex_alloc_zeroed_T(Thread_Pool);
+		self->workers_count = 1;
+		return self;
+	}
+
+	void
+	thread_pool_deinit(Thread_Pool* self)
+	{
+		rex_dealloc(self);
+	}
+
+	u32
+	thread_pool_workers_count(const Thread_Pool* self)
+	{
+		return self->workers_count;
+	}
+
+	void
+	thread_pool_run(Thread_Pool*, u32 count, task_proc_t proc, void* user_data)
+	{
+		for (u32 i = 0; i < count; ++i)
+			proc(user_data, i, 0);
+	}
+}
+
+#endif
@@ -230,6 +230,13 @@ namespace rc
 
 	}
 
+	u32*
+	window_back_buffer(Window*, i32, i32)
+	{
+		// the pixels are copied into the canvas image data anyway
+		return nullptr;
+	}
+
 	void
 	window_blit(Window* self, u32* pixels, i32 width, i32 height)
 	{
@@ -34,6 +34,69 @@ namespace rc
 
 		return res;
 	}
+
+	File_Map
+	file_map(const char* path)
+	{
+		HANDLE hfile = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, 0);
+		if (hfile == INVALID_HANDLE_VALUE)
+			return {};
+
+		LARGE_INTEGER size = {};
+		if (GetFileSizeEx(hfile, &size) == false)
+		{
+			CloseHandle(hfile);
+			return {};
+		}
+
+		// empty files can't be mapped, hand out an empty view instead
+		File_Map self = {};
+		self.ptr = "";
+		if (size.QuadPart > 0)
+		{
+			HANDLE hmapping = CreateFileMappingA(hfile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			auto ptr = hmapping ? MapViewOfFile(hmapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+			if (ptr == nullptr)
+			{
+				if (hmapping)
+					CloseHandle(hmapping);
+				CloseHandle(hfile);
+				return {};
+			}
+
+			// the view keeps the mapping and the file alive on its own
+			CloseHandle(hmapping);
+			self.ptr = (const char*)ptr;
+			self.count = (sz)size.QuadPart;
+			self.handle = ptr;
+		}
+
+		CloseHandle(hfile);
+		return self;
+	}
+
+	void
+	file_unmap(File_Map& self)
+	{
+		if (self.handle)
+			UnmapViewOfFile(self.handle);
+		self = {};
+	}
+
+	File_Info
+	file_info(const char* path)
+	{
+		WIN32_FILE_ATTRIBUTE_DATA data = {};
+		if (GetFileAttributesExA(path, GetFileExInfoStandard, &data) == false)
+			return {};
+
+		// FILETIME counts 100ns intervals
+		File_Info self = {};
+		self.exists = true;
+		self.size = ((u64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+		self.modified_ns = (i64)(((u64)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime) * 100;
+		return self;
+	}
 }
 
 #endif
@@ -0,0 +1,177 @@
+#if REX_OS_WINDOWS
+
+#include "rex-core/thread.h"
+#include "rex-core/memory.h"
+#include "rex-core/assert.h"
+
+#include <windows.h>
+
+namespace rc
+{
+	static constexpr u32 THREAD_POOL_MAX_WORKERS = 64;
+
+	struct Thread_Pool_Worker
+	{
+		Thread_Pool* pool;
+		HANDLE handle;
+		u32 index;
+	};
+
+	struct Thread_Pool
+	{
+		Thread_Pool_Worker workers[THREAD_POOL_MAX_WORKERS];
+		u32 workers_count;
+
+		CRITICAL_SECTION mutex;
+		CONDITION_VARIABLE work_cond;
+		CONDITION_VARIABLE done_cond;
+
+		// current job, guarded by the mutex except for next which workers claim atomically
+		task_proc_t proc;
+		void* user_data;
+		u32 count;
+		volatile LONG next;
+		u32 busy;
+		u64 generation;
+		bool quit;
+	};
+
+	inline static void
+	_thread_pool_drain(Thread_Pool* self, task_proc_t proc, void* user_data, u32 count, u32 worker)
+	{
+		for (;;)
+		{
+			auto index = (u32)(InterlockedIncrement(&self->next) - 1);
+			if (index >= count)
+				break;
+			proc(user_data, index, worker);
+		}
+	}
+
+	static DWORD WINAPI
+	_thread_pool_worker_main(LPVOID user_data)
+	{
+		auto worker = (Thread_Pool_Worker*)user_data;
+		auto self = worker->pool;
+		u64 generation = 0;
+
+		EnterCriticalSection(&self->mutex);
+		for (;;)
+		{
+			while (self->quit == false && self->generation == generation)
+				SleepConditionVariableCS(&self->work_cond, &self->mutex, INFINITE);
+
+			if (self->quit)
+				break;
+
+			generation = self->generation;
+			auto proc = self->proc;
+			auto job_user_data = self->user_data;
+			auto count = self->count;
+			LeaveCriticalSection(&self->mutex);
+
+			_thread_pool_drain(self, proc, job_user_data, count, worker->index);
+
+			EnterCriticalSection(&self->mutex);
+			if (--self->busy == 0)
+				WakeConditionVariable(&self->done_cond);
+		}
+		LeaveCriticalSection(&self->mutex);
+
+		return 0;
+	}
+
+	u32
+	thread_cores_count()
+	{
+		SYSTEM_INFO info = {};
+		GetSystemInfo(&info);
+		return info.dwNumberOfProcessors > 0 ? (u32)info.dwNumberOfProcessors : 1;
+	}
+
+	Thread_Pool*
+	thread_pool_init(u32 workers_count)
+	{
+		if (workers_count == 0)
+			workers_count = thread_cores_count();
+		if (workers_count > THREAD_POOL_MAX_WORKERS)
+			workers_count = THREAD_POOL_MAX_WORKERS;
+
+		auto self = rex_alloc_zeroed_T(Thread_Pool);
+		self->workers_count = workers_count;
+
+		InitializeCriticalSection(&self->mutex);
+		InitializeConditionVariable(&self->work_cond);
+		InitializeConditionVariable(&self->done_cond);
+
+		// worker 0 is the calling thread
+		for (u32 i = 1; i < workers_count; ++i)
+		{
+			auto worker = &self->workers[i];
+			worker->pool = self;
+			worker->index = i;
+			worker->handle = CreateThread(nullptr, 0, _thread_pool_worker_main, worker, 0, nullptr);
+			rex_assert_msg(worker->handle, "[rex-core]: failed to create worker thread");
+		}
+
+		return self;
+	}
+
+	void
+	thread_pool_deinit(Thread_Pool* self)
+	{
+		if (self == nullptr)
+			return;
+
+		EnterCriticalSection(&self->mutex);
+		self->quit = true;
+		WakeAllConditionVariable(&self->work_cond);
+		LeaveCriticalSection(&self->mutex);
+
+		for (u32 i = 1; i < self->workers_count; ++i)
+		{
+			WaitForSingleObject(self->workers[i].handle, INFINITE);
+			CloseHandle(self->workers[i].handle);
+		}
+
+		DeleteCriticalSection(&self->mutex);
+
+		rex_dealloc(self);
+	}
+
+	u32
+	thread_pool_workers_count(const Thread_Pool* self)
+	{
+		return self->workers_count;
+	}
+
+	void
+	thread_pool_run(Thread_Pool* self, u32 count, task_proc_t proc, void* user_data)
+	{
+		if (self->workers_count == 1 || count <= 1)
+		{
+			for (u32 i = 0; i < count; ++i)
+				proc(user_data, i, 0);
+			return;
+		}
+
+		EnterCriticalSection(&self->mutex);
+		self->proc = proc;
+		self->user_data = user_data;
+		self->count = count;
+		self->next = 0;
+		self->busy = self->workers_count - 1;
+		self->generation++;
+		WakeAllConditionVariable(&self->work_cond);
+		LeaveCriticalSection(&self->mutex);
+
+		_thread_pool_drain(self, proc, user_data, count, 0);
+
+		EnterCriticalSection(&self->mutex);
+		while (self->busy > 0)
+			SleepConditionVariableCS(&self->done_cond, &self->mutex, INFINITE);
+		LeaveCriticalSection(&self->mutex);
+	}
+}
+
+#endif
@@ -29,6 +29,22 @@ namespace rc
 		return milliseconds;
 	}
 
+	u64
+	time_nanoseconds()
+	{
+		static LARGE_INTEGER frequency = {};
+		if (frequency.QuadPart == 0)
+			QueryPerformanceFrequency(&frequency);
+
+		LARGE_INTEGER ticks = {};
+		QueryPerformanceCounter(&ticks);
+
+		// split to avoid overflowing the multiplication
+		auto seconds = (u64)ticks.QuadPart / (u64)frequency.QuadPart;
+		auto remainder = (u64)ticks.QuadPart % (u64)frequency.QuadPart;
+		return seconds * 1'000'000'000 + remainder * 1'000'000'000 / (u64)frequency.QuadPart;
+	}
+
 	void
 	sleep(u32 milliseconds)
 	{
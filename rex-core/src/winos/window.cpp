@@ -298,6 +298,13 @@ namespace rc
 		SetWindowTextA((HWND)self->native_handle, title);
 	}
 
+	uint32_t*
+	window_back_buffer(Window*, i32, i32)
+	{
+		// StretchDIBits reads from any memory
+		return nullptr;
+	}
+
 	void
 	window_blit(Window* window, uint32_t* pixels, i32 width, i32 height)
 	{
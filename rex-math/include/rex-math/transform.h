@@ -0,0 +1,150 @@
+#pragma once
+
+#include "rex-math/types.h"
+
+#include <stddef.h>
+
+// sse2 is part of x86-64 so it doesn't need runtime detection
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+	#define REX_MATH_SSE2 1
+	#include <emmintrin.h>
+#else
+	#define REX_MATH_SSE2 0
+#endif
+
+namespace rex::math
+{
+	// structure of arrays views, every array holds the same number of floats
+	struct SoA_V3
+	{
+		float *x, *y, *z;
+	};
+
+	struct SoA_V4
+	{
+		float *x, *y, *z, *w;
+	};
+
+	// (p, 1) * M, same order of operations as Vec4 * Mat4 so both give the same result
+	inline static Vec4<float>
+	_mat4_transform_point(const Mat4<float> &M, const Vec3<float> &p)
+	{
+		return {
+			p.x * M[0][0] + p.y * M[1][0] + p.z * M[2][0] + M[3][0],
+			p.x * M[0][1] + p.y * M[1][1] + p.z * M[2][1] + M[3][1],
+			p.x * M[0][2] + p.y * M[1][2] + p.z * M[2][2] + M[3][2],
+			p.x * M[0][3] + p.y * M[1][3] + p.z * M[2][3] + M[3][3]
+		};
+	}
+
+#if REX_MATH_SSE2
+	struct _Mat4_SSE2
+	{
+		__m128 m[4][4];
+	};
+
+	inline static _Mat4_SSE2
+	_mat4_sse2(const Mat4<float> &M)
+	{
+		_Mat4_SSE2 self;
+		for (int r = 0; r < 4; ++r)
+			for (int c = 0; c < 4; ++c)
+				self.m[r][c] = _mm_set1_ps(M[r][c]);
+		return self;
+	}
+
+	// transforms 4 packed Vec3 (12 floats) into x, y, z, w lanes
+	inline static void
+	_mat4_transform_points4(const _Mat4_SSE2 &M, const Vec3<float> *points, __m128 (&out)[4])
+	{
+		auto p = (const float *)points;
+		auto r0 = _mm_loadu_ps(p + 0); // x0 y0 z0 x1
+		auto r1 = _mm_loadu_ps(p + 4); // y1 z1 x2 y2
+		auto r2 = _mm_loadu_ps(p + 8); // z2 x3 y3 z3
+
+		auto x23 = _mm_shuffle_ps(r1, r2, _MM_SHUFFLE(1, 1, 2, 2));
+		auto x = _mm_shuffle_ps(r0, x23, _MM_SHUFFLE(2, 0, 3, 0));
+		auto y01 = _mm_shuffle_ps(r0, r1, _MM_SHUFFLE(0, 0, 1, 1));
+		auto y23 = _mm_shuffle_ps(r1, r2, _MM_SHUFFLE(2, 2, 3, 3));
+		auto y = _mm_shuffle_ps(y01, y23, _MM_SHUFFLE(2, 0, 2, 0));
+		auto z01 = _mm_shuffle_ps(r0, r1, _MM_SHUFFLE(1, 1, 2, 2));
+		auto z23 = _mm_shuffle_ps(r2, r2, _MM_SHUFFLE(3, 3, 0, 0));
+		auto z = _mm_shuffle_ps(z01, z23, _MM_SHUFFLE(2, 0, 2, 0));
+
+		for (int c = 0; c < 4; ++c)
+		{
+			auto v = _mm_mul_ps(x, M.m[0][c]);
+			v = _mm_add_ps(v, _mm_mul_ps(y, M.m[1][c]));
+			v = _mm_add_ps(v, _mm_mul_ps(z, M.m[2][c]));
+			out[c] = _mm_add_ps(v, M.m[3][c]);
+		}
+	}
+#endif
+
+	// out[i] = (points[i], 1) * M
+	inline static void
+	mat4_transform_points(const Mat4<float> &M, const Vec3<float> *points, size_t count, SoA_V4 out)
+	{
+		size_t i = 0;
+	#if REX_MATH_SSE2
+		auto M4 = _mat4_sse2(M);
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 v[4];
+			_mat4_transform_points4(M4, points + i, v);
+			_mm_storeu_ps(out.x + i, v[0]);
+			_mm_storeu_ps(out.y + i, v[1]);
+			_mm_storeu_ps(out.z + i, v[2]);
+			_mm_storeu_ps(out.w + i, v[3]);
+		}
+	#endif
+		for (; i < count; ++i)
+		{
+			auto v = _mat4_transform_point(M, points[i]);
+			out.x[i] = v.x;
+			out.y[i] = v.y;
+			out.z[i] = v.z;
+			out.w[i] = v.w;
+		}
+	}
+
+	// clip[i] = (points[i], 1) * M and screen[i] = clip[i].xyz * (1 / clip[i].w), with the viewport
+	// transform folded into M the screen arrays hold pixel coordinates. one division per point, the
+	// result can be 1 ulp away from dividing each coordinate by w
+	inline static void
+	mat4_project_points(const Mat4<float> &M, const Vec3<float> *points, size_t count, SoA_V4 clip, SoA_V3 screen)
+	{
+		size_t i = 0;
+	#if REX_MATH_SSE2
+		auto M4 = _mat4_sse2(M);
+		auto one = _mm_set1_ps(1.0f);
+		for (; i + 4 <= count; i += 4)
+		{
+			__m128 v[4];
+			_mat4_transform_points4(M4, points + i, v);
+			_mm_storeu_ps(clip.x + i, v[0]);
+			_mm_storeu_ps(clip.y + i, v[1]);
+			_mm_storeu_ps(clip.z + i, v[2]);
+			_mm_storeu_ps(clip.w + i, v[3]);
+
+			auto inv_w = _mm_div_ps(one, v[3]);
+			_mm_storeu_ps(screen.x + i, _mm_mul_ps(v[0], inv_w));
+			_mm_storeu_ps(screen.y + i, _mm_mul_ps(v[1], inv_w));
+			_mm_storeu_ps(screen.z + i, _mm_mul_ps(v[2], inv_w));
+		}
+	#endif
+		for (; i < count; ++i)
+		{
+			auto v = _mat4_transform_point(M, points[i]);
+			clip.x[i] = v.x;
+			clip.y[i] = v.y;
+			clip.z[i] = v.z;
+			clip.w[i] = v.w;
+
+			auto inv_w = 1.0f / v.w;
+			screen.x[i] = v.x * inv_w;
+			screen.y[i] = v.y * inv_w;
+			screen.z[i] = v.z * inv_w;
+		}
+	}
+}
@@ -1,31 +1,73 @@
 #pragma once
 
+#include <rex-core/api.h>
 #include <rex-core/vec.h>
 #include <rex-math/types.h>
 
+#include <float.h>
+
 namespace rex::raster
 {
+	// the depth buffer is covered by DEPTH_BLOCK_SIZE x DEPTH_BLOCK_SIZE blocks with coarse depth bounds
+	// so the rasterizer can reject occluded parts of a triangle before any per pixel work
+	static constexpr int DEPTH_BLOCK_SIZE = 8;
+
+	// visibility buffer value of the pixels no triangle covers
+	static constexpr rc::u32 VISIBILITY_NONE = 0xFFFFFFFF;
+
+	enum CANVAS_FORMAT
+	{
+		// 8-bit color packed in the window byte order, blitting it to the screen is a memcpy
+		CANVAS_FORMAT_PIXEL,
+		// float color, for hdr accumulation or sampling, converted to 8-bit when blitted
+		CANVAS_FORMAT_F32,
+	};
+
 	struct Canvas
 	{
+		CANVAS_FORMAT format;
+		// only the color buffer matching the format is allocated
+		rc::Vec<Rex_Pixel> pixels;
 		rc::Vec<math::Color_F32> color;
 		rc::Vec<float> depth;
+		// index of the triangle visible at each pixel, only allocated and written by visibility rendering
+		rc::Vec<rc::u32> visibility;
 		int width, height;
+
+		// conservative bounds of each depth block, no depth inside a block is below its min or above
+		// its max, the bounds are only refined by the rasterizer so they may be looser than the pixels
+		rc::Vec<float> depth_block_min;
+		rc::Vec<float> depth_block_max;
+		// blocks written since their max was last computed from the pixels
+		rc::Vec<bool> depth_block_dirty;
+		int blocks_x, blocks_y;
 	};
 
 	inline static Canvas
-	canvas_init()
+	canvas_init(CANVAS_FORMAT format = CANVAS_FORMAT_F32)
 	{
 		Canvas self = {};
+		self.format = format;
+		self.pixels = rc::vec_init<Rex_Pixel>();
 		self.color = rc::vec_init<math::Color_F32>();
 		self.depth = rc::vec_init<float>();
+		self.visibility = rc::vec_init<rc::u32>();
+		self.depth_block_min = rc::vec_init<float>();
+		self.depth_block_max = rc::vec_init<float>();
+		self.depth_block_dirty = rc::vec_init<bool>();
 		return self;
 	}
 
 	inline static void
 	canvas_deinit(Canvas& self)
 	{
+		rc::vec_deinit(self.pixels);
 		rc::vec_deinit(self.color);
 		rc::vec_deinit(self.depth);
+		rc::vec_deinit(self.visibility);
+		rc::vec_deinit(self.depth_block_min);
+		rc::vec_deinit(self.depth_block_max);
+		rc::vec_deinit(self.depth_block_dirty);
 		self = {};
 	}
 
@@ -38,18 +80,110 @@ namespace rex::raster
 		if (width == 0 || height == 0)
 			return;
 
-		rc::vec_resize(self.color, width * height);
+		if (self.format == CANVAS_FORMAT_PIXEL)
+			rc::vec_resize(self.pixels, width * height);
+		else
+			rc::vec_resize(self.color, width * height);
 		rc::vec_resize(self.depth, width * height);
 
 		self.width = width;
 		self.height = height;
+
+		// the contents are garbage after a resize anyway, so any block bounds are valid until the next clear
+		self.blocks_x = (width + DEPTH_BLOCK_SIZE - 1) / DEPTH_BLOCK_SIZE;
+		self.blocks_y = (height + DEPTH_BLOCK_SIZE - 1) / DEPTH_BLOCK_SIZE;
+		rc::vec_resize(self.depth_block_min, self.blocks_x * self.blocks_y);
+		rc::vec_resize(self.depth_block_max, self.blocks_x * self.blocks_y);
+		rc::vec_resize(self.depth_block_dirty, self.blocks_x * self.blocks_y);
+		rc::vec_fill(self.depth_block_min, -FLT_MAX);
+		rc::vec_fill(self.depth_block_max, FLT_MAX);
+		rc::vec_fill(self.depth_block_dirty, true);
+	}
+
+	// same rounding as the blit of a float canvas
+	inline static Rex_Pixel
+	pixel_from_color(math::Color_F32 color)
+	{
+		Rex_Pixel self = {};
+		self.r = (uint8_t)(color.r * 255);
+		self.g = (uint8_t)(color.g * 255);
+		self.b = (uint8_t)(color.b * 255);
+		self.a = (uint8_t)(color.a * 255);
+		return self;
 	}
 
 	inline static void
 	canvas_clear(Canvas& self, math::Color_F32 color, float depth)
 	{
-		rc::vec_fill(self.color, color);
+		if (self.format == CANVAS_FORMAT_PIXEL)
+			rc::vec_fill(self.pixels, pixel_from_color(color));
+		else
+			rc::vec_fill(self.color, color);
 		rc::vec_fill(self.depth, depth);
+		rc::vec_fill(self.depth_block_min, depth);
+		rc::vec_fill(self.depth_block_max, depth);
+		rc::vec_fill(self.depth_block_dirty, false);
+	}
+
+	// clears the inclusive pixel rect [min, max]
+	inline static void
+	canvas_clear(Canvas& self, math::Color_F32 color, float depth, math::V2i min, math::V2i max)
+	{
+		auto pixel = pixel_from_color(color);
+		for (int y = min.y; y <= max.y; ++y)
+		{
+			auto row = (rc::sz)y * self.width;
+			if (self.format == CANVAS_FORMAT_PIXEL)
+			{
+				auto pixels = self.pixels.ptr + row;
+				for (int x = min.x; x <= max.x; ++x)
+					pixels[x] = pixel;
+			}
+			else
+			{
+				auto colors = self.color.ptr + row;
+				for (int x = min.x; x <= max.x; ++x)
+					colors[x] = color;
+			}
+
+			auto depths = self.depth.ptr + row;
+			for (int x = min.x; x <= max.x; ++x)
+				depths[x] = depth;
+		}
+
+		// blocks fully inside the rect take the clear depth, the ones on its border only widen
+		for (int by = min.y / DEPTH_BLOCK_SIZE; by <= max.y / DEPTH_BLOCK_SIZE; ++by)
+		{
+			for (int bx = min.x / DEPTH_BLOCK_SIZE; bx <= max.x / DEPTH_BLOCK_SIZE; ++bx)
+			{
+				auto i = by * self.blocks_x + bx;
+				auto block_max_x = (bx + 1) * DEPTH_BLOCK_SIZE - 1;
+				auto block_max_y = (by + 1) * DEPTH_BLOCK_SIZE - 1;
+				if (block_max_x >= self.width)  block_max_x = self.width - 1;
+				if (block_max_y >= self.height) block_max_y = self.height - 1;
+
+				bool inside =
+					bx * DEPTH_BLOCK_SIZE >= min.x && block_max_x <= max.x &&
+					by * DEPTH_BLOCK_SIZE >= min.y && block_max_y <= max.y;
+				if (inside)
+				{
+					self.depth_block_min[i] = depth;
+					self.depth_block_max[i] = depth;
+					self.depth_block_dirty[i] = false;
+				}
+				else
+				{
+					self.depth_block_min[i] = depth < self.depth_block_min[i] ? depth : self.depth_block_min[i];
+					self.depth_block_max[i] = depth > self.depth_block_max[i] ? depth : self.depth_block_max[i];
+				}
+			}
+		}
+	}
+
+	inline static Rex_Pixel&
+	canvas_pixel(Canvas& self, int x, int y)
+	{
+		return self.pixels[y * self.width + x];
 	}
 
 	inline static math::Color_F32&
@@ -64,6 +198,35 @@ namespace rex::raster
 		return self.color[y * self.width + x];
 	}
 
+	// writes a color to whichever color buffer the canvas has
+	inline static void
+	canvas_write(Canvas& self, int x, int y, math::Color_F32 color)
+	{
+		if (self.format == CANVAS_FORMAT_PIXEL)
+			canvas_pixel(self, x, y) = pixel_from_color(color);
+		else
+			canvas_color(self, x, y) = color;
+	}
+
+	// sizes the visibility buffer to the canvas, it stays unallocated until visibility rendering is used
+	inline static void
+	canvas_visibility_resize(Canvas& self)
+	{
+		rc::vec_resize(self.visibility, (rc::sz)self.width * self.height);
+	}
+
+	// clears the visibility of the inclusive pixel rect [min, max]
+	inline static void
+	canvas_visibility_clear(Canvas& self, math::V2i min, math::V2i max)
+	{
+		for (int y = min.y; y <= max.y; ++y)
+		{
+			auto row = self.visibility.ptr + (rc::sz)y * self.width;
+			for (int x = min.x; x <= max.x; ++x)
+				row[x] = VISIBILITY_NONE;
+		}
+	}
+
 	inline static float&
 	canvas_depth(Canvas& self, int x, int y)
 	{
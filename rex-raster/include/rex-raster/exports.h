@@ -0,0 +1,42 @@
+
+#ifndef REX_RASTER_EXPORT_H
+#define REX_RASTER_EXPORT_H
+
+#ifdef REX_RASTER_STATIC_DEFINE
+#  define REX_RASTER_EXPORT
+#  define REX_RASTER_NO_EXPORT
+#else
+#  ifndef REX_RASTER_EXPORT
+#    ifdef rex_raster_EXPORTS
+        /* We are building this library */
+#      define REX_RASTER_EXPORT 
+#    else
+        /* We are using this library */
+#      define REX_RASTER_EXPORT 
+#    endif
+#  endif
+
+#  ifndef REX_RASTER_NO_EXPORT
+#    define REX_RASTER_NO_EXPORT 
+#  endif
+#endif
+
+#ifndef REX_RASTER_DEPRECATED
+#  define REX_RASTER_DEPRECATED __attribute__ ((__deprecated__))
+#endif
+
+#ifndef REX_RASTER_DEPRECATED_EXPORT
+#  define REX_RASTER_DEPRECATED_EXPORT REX_RASTER_EXPORT REX_RASTER_DEPRECATED
+#endif
+
+#ifndef REX_RASTER_DEPRECATED_NO_EXPORT
+#  define REX_RASTER_DEPRECATED_NO_EXPORT REX_RASTER_NO_EXPORT REX_RASTER_DEPRECATED
+#endif
+
+#if 0 /* DEFINE_NO_DEPRECATED */
+#  ifndef REX_RASTER_NO_DEPRECATED
+#    define REX_RASTER_NO_DEPRECATED
+#  endif
+#endif
+
+#endif /* REX_RASTER_EXPORT_H */
@@ -2,6 +2,8 @@
 
 #include "rex-raster/exports.h"
 
+#include <rex-core/file.h>
+#include <rex-core/thread.h>
 #include <rex-core/vec.h>
 #include <rex-math/types.h>
 
@@ -14,10 +16,15 @@ namespace rex::raster
 		rc::Vec<math::V2> uv;
 		rc::Vec<math::Color_F32> color;
 		rc::Vec<unsigned> indices;
+		// empty or one per index
 		rc::Vec<unsigned> uv_indices;
 
 		math::V3 bb_min;
 		math::V3 bb_max;
+
+		// set when loaded from a .rexmesh, the vectors then point into this read only mapping instead of
+		// owning their memory
+		rc::File_Map storage;
 	};
 
 	REX_RASTER_EXPORT Mesh mesh_init();
@@ -28,5 +35,19 @@ namespace rex::raster
 	REX_RASTER_EXPORT Mesh mesh_cube();
 
 	REX_RASTER_EXPORT Mesh mesh_from_stl(const char* path);
-	REX_RASTER_EXPORT Mesh mesh_from_obj(const char* path);
+	// with workers, big files are split at line boundaries and parsed in parallel chunks, the result is the
+	// same as the serial parse. malformed records or indices out of the file's vertices log and return an
+	// empty mesh
+	REX_RASTER_EXPORT Mesh mesh_from_obj(const char* path, rc::Thread_Pool* workers = nullptr);
+
+	// .rexmesh is the binary mesh format, the arrays are stored aligned after a small header so loading maps
+	// the file and uses them in place once every index is checked. source is the size and modification time
+	// of the file it was converted from, caches compare it against the source to know they're still fresh
+	REX_RASTER_EXPORT Mesh mesh_from_rexmesh(const char* path);
+	REX_RASTER_EXPORT bool mesh_save_rexmesh(const Mesh& self, const char* path, const rc::File_Info& source = {});
+
+	// loads .obj, .stl, .glb, .gltf and .rexmesh files, obj, stl and glb are converted once to a
+	// "<path>.rexmesh" cache next to them which later loads map as long as the source keeps its size and
+	// modification time
+	REX_RASTER_EXPORT Mesh mesh_load(const char* path, rc::Thread_Pool* workers = nullptr);
 }
@@ -0,0 +1,527 @@
+#pragma once
+
+#include <rex-core/types.h>
+#include <rex-core/vec.h>
+#include <rex-math/types.h>
+#include <rex-math/math.h>
+#include <rex-math/vec2.h>
+#include <rex-math/vec3.h>
+#include <rex-math/vec4.h>
+#include <rex-math/mat4.h>
+#include <rex-math/transform.h>
+
+namespace rex::raster
+{
+	// the screen is split into TILE_SIZE x TILE_SIZE tiles, each tile is owned by a single worker
+	// while rasterizing so workers never touch the same pixels
+	static constexpr int TILE_SIZE = 64;
+
+	// vertices are snapped to 1/16th of a pixel (28.4 fixed point) before computing the edge functions
+	static constexpr int SUBPIXEL_BITS = 4;
+	static constexpr int SUBPIXEL_ONE  = 1 << SUBPIXEL_BITS;
+	// vertices further than this (in pixels) from the origin are rejected to keep the edge functions
+	// inside 64-bit range
+	static constexpr float GUARD_BAND = (float)(1 << 24);
+
+	// half-space edge function e(x, y) = a * x + b * y + c evaluated at the center of pixel (x, y),
+	// pixels with e + bias >= 0 are inside the edge, the bias is kept out of c so the barycentric
+	// weights stay exact
+	struct Edge
+	{
+		rc::i64 a, b, c;
+		rc::i64 bias;
+	};
+
+	// linear attribute interpolation, value(x, y) = c + dx * (x - bb_min.x) + dy * (y - bb_min.y),
+	// relative to the triangle bounds so that the float math stays precise far from the origin
+	struct Plane
+	{
+		float dx, dy, c;
+	};
+
+	// screen space triangle ready for rasterization
+	struct Triangle
+	{
+		math::V3 p0, p1, p2;
+		math::V2 uv0, uv1, uv2;
+
+		// edges[0] is opposite to p0, edges[1] to p1, and edges[2] to p2 so that the barycentric
+		// weight of each vertex is its edge function divided by the triangle area
+		Edge edges[3];
+
+		// depth and texture coordinates
+		Plane z, u, v;
+		// lit color, flat when the corners have the same color
+		Plane r, g, b;
+
+		// inclusive pixel bounds, already clipped to the canvas
+		math::V2i bb_min, bb_max;
+	};
+
+	inline static rc::i64
+	_fixed(float v)
+	{
+		return (rc::i64)(v * SUBPIXEL_ONE + (v < 0 ? -0.5f : 0.5f));
+	}
+
+	// top-left fill rule: pixel centers exactly on an edge only belong to the triangle if the edge is
+	// a top edge or a left edge, so triangles sharing an edge never draw the same pixel twice
+	inline static Edge
+	_edge_setup(rc::i64 ax, rc::i64 ay, rc::i64 bx, rc::i64 by)
+	{
+		auto dx = bx - ax;
+		auto dy = by - ay;
+		bool top_left = dy < 0 || (dy == 0 && dx > 0);
+
+		Edge self = {};
+		self.a = -dy * SUBPIXEL_ONE;
+		self.b =  dx * SUBPIXEL_ONE;
+		self.c = dx * (SUBPIXEL_ONE / 2 - ay) - dy * (SUBPIXEL_ONE / 2 - ax);
+		self.bias = top_left ? 0 : -1;
+		return self;
+	}
+
+	// value(x, y) = (f0 * e0(x, y) + f1 * e1(x, y) + f2 * e2(x, y)) / area, computed in double
+	inline static Plane
+	_plane_setup(const Edge (&edges)[3], rc::i64 area, math::V2i origin, float f0, float f1, float f2)
+	{
+		double f[3] = {f0, f1, f2};
+		double dx = 0, dy = 0, c = 0;
+		for (int i = 0; i < 3; ++i)
+		{
+			dx += f[i] * (double)edges[i].a;
+			dy += f[i] * (double)edges[i].b;
+			c  += f[i] * (double)(edges[i].a * origin.x + edges[i].b * origin.y + edges[i].c);
+		}
+
+		Plane self = {};
+		self.dx = (float)(dx / (double)area);
+		self.dy = (float)(dy / (double)area);
+		self.c  = (float)(c / (double)area);
+		return self;
+	}
+
+	inline static Plane
+	_plane_flat(float value)
+	{
+		return Plane{0.0f, 0.0f, value};
+	}
+
+	// vertex after the model, view, projection and viewport transforms and before the perspective
+	// divide, the viewport keeps w so it's inside the view frustum if 0 <= x <= width * w,
+	// 0 <= y <= height * w and 0 <= z <= w
+	struct Clip_Vertex
+	{
+		math::V4 position;
+		math::V2 uv;
+		math::Color_F32 color;
+	};
+
+	enum CLIP_PLANE: rc::u32
+	{
+		CLIP_PLANE_LEFT   = 1 << 0,
+		CLIP_PLANE_RIGHT  = 1 << 1,
+		CLIP_PLANE_TOP    = 1 << 2,
+		CLIP_PLANE_BOTTOM = 1 << 3,
+		CLIP_PLANE_NEAR   = 1 << 4,
+		CLIP_PLANE_FAR    = 1 << 5,
+
+		// the side planes are pushed out to the guard band, triangles only get clipped against them if
+		// they would overflow the fixed point coordinates, everything else is clipped by the rasterizer
+		CLIP_PLANE_GUARD_LEFT   = 1 << 6,
+		CLIP_PLANE_GUARD_RIGHT  = 1 << 7,
+		CLIP_PLANE_GUARD_TOP    = 1 << 8,
+		CLIP_PLANE_GUARD_BOTTOM = 1 << 9,
+
+		CLIP_PLANE_VIEW = CLIP_PLANE_LEFT | CLIP_PLANE_RIGHT | CLIP_PLANE_TOP | CLIP_PLANE_BOTTOM | CLIP_PLANE_NEAR | CLIP_PLANE_FAR,
+		CLIP_PLANE_CLIP = CLIP_PLANE_NEAR | CLIP_PLANE_GUARD_LEFT | CLIP_PLANE_GUARD_RIGHT | CLIP_PLANE_GUARD_TOP | CLIP_PLANE_GUARD_BOTTOM,
+	};
+
+	// each clip plane adds at most one vertex to the triangle
+	static constexpr int CLIP_MAX_VERTICES = 3 + 5;
+
+	// signed distance of p to the plane, positive inside, viewport is the canvas size
+	inline static float
+	_clip_distance(const math::V4& p, CLIP_PLANE plane, math::V2 viewport)
+	{
+		switch (plane)
+		{
+			case CLIP_PLANE_LEFT:         return p.x;
+			case CLIP_PLANE_RIGHT:        return viewport.width * p.w - p.x;
+			case CLIP_PLANE_TOP:          return p.y;
+			case CLIP_PLANE_BOTTOM:       return viewport.height * p.w - p.y;
+			case CLIP_PLANE_NEAR:         return p.z;
+			case CLIP_PLANE_FAR:          return p.w - p.z;
+			case CLIP_PLANE_GUARD_LEFT:   return GUARD_BAND * p.w + p.x;
+			case CLIP_PLANE_GUARD_RIGHT:  return GUARD_BAND * p.w - p.x;
+			case CLIP_PLANE_GUARD_TOP:    return GUARD_BAND * p.w + p.y;
+			case CLIP_PLANE_GUARD_BOTTOM: return GUARD_BAND * p.w - p.y;
+			default:                      return 0.0f;
+		}
+	}
+
+	// bit mask of the planes p is outside of
+	inline static rc::u32
+	clip_outcode(const math::V4& p, math::V2 viewport)
+	{
+		rc::u32 self = 0;
+		for (rc::u32 plane = CLIP_PLANE_LEFT; plane <= CLIP_PLANE_GUARD_BOTTOM; plane <<= 1)
+			if ((_clip_distance(p, (CLIP_PLANE)plane, viewport) >= 0.0f) == false)
+				self |= plane;
+		return self;
+	}
+
+	// sutherland-hodgman clipping of a convex polygon against the given planes, returns the new vertex
+	// count which is 0 if nothing is left
+	inline static int
+	clip_polygon(Clip_Vertex (&vertices)[CLIP_MAX_VERTICES], int count, rc::u32 planes, math::V2 viewport)
+	{
+		Clip_Vertex clipped[CLIP_MAX_VERTICES];
+		for (rc::u32 plane = CLIP_PLANE_LEFT; plane <= CLIP_PLANE_GUARD_BOTTOM; plane <<= 1)
+		{
+			if ((planes & plane) == 0)
+				continue;
+
+			int clipped_count = 0;
+			for (int i = 0; i < count; ++i)
+			{
+				auto& a = vertices[i];
+				auto& b = vertices[(i + 1) % count];
+				auto da = _clip_distance(a.position, (CLIP_PLANE)plane, viewport);
+				auto db = _clip_distance(b.position, (CLIP_PLANE)plane, viewport);
+
+				if (da >= 0.0f)
+					clipped[clipped_count++] = a;
+
+				if ((da >= 0.0f) != (db >= 0.0f))
+				{
+					auto t = da / (da - db);
+					clipped[clipped_count].position = a.position + (b.position - a.position) * t;
+					clipped[clipped_count].uv = a.uv + (b.uv - a.uv) * t;
+					clipped[clipped_count].color = math::Color_F32{
+						a.color.r + (b.color.r - a.color.r) * t,
+						a.color.g + (b.color.g - a.color.g) * t,
+						a.color.b + (b.color.b - a.color.b) * t,
+						a.color.a + (b.color.a - a.color.a) * t,
+					};
+					++clipped_count;
+				}
+			}
+
+			if (clipped_count < 3)
+				return 0;
+
+			for (int i = 0; i < clipped_count; ++i)
+				vertices[i] = clipped[i];
+			count = clipped_count;
+		}
+		return count;
+	}
+
+	// post-transform vertices in structure of arrays layout, every mesh position is transformed once
+	// per frame and shared by all the triangles using it
+	struct Vertices
+	{
+		rc::Vec<float> clip_x, clip_y, clip_z, clip_w;
+		// clip divided by w, only meaningful if the vertex isn't behind the near plane
+		rc::Vec<float> screen_x, screen_y, screen_z;
+		rc::Vec<rc::u32> outcode;
+	};
+
+	inline static Vertices
+	vertices_init()
+	{
+		Vertices self = {};
+		for (auto v: {&self.clip_x, &self.clip_y, &self.clip_z, &self.clip_w, &self.screen_x, &self.screen_y, &self.screen_z})
+			*v = rc::vec_init<float>();
+		self.outcode = rc::vec_init<rc::u32>();
+		return self;
+	}
+
+	inline static void
+	vertices_deinit(Vertices& self)
+	{
+		for (auto v: {&self.clip_x, &self.clip_y, &self.clip_z, &self.clip_w, &self.screen_x, &self.screen_y, &self.screen_z})
+			rc::vec_deinit(*v);
+		rc::vec_deinit(self.outcode);
+		self = {};
+	}
+
+	inline static math::V4
+	vertices_clip(const Vertices& self, rc::sz i)
+	{
+		return {self.clip_x[i], self.clip_y[i], self.clip_z[i], self.clip_w[i]};
+	}
+
+	inline static math::V3
+	vertices_screen(const Vertices& self, rc::sz i)
+	{
+		return {self.screen_x[i], self.screen_y[i], self.screen_z[i]};
+	}
+
+	// mvpv is the model, view, projection and viewport matrices concatenated
+	inline static void
+	vertices_transform(Vertices& self, const rc::Vec<math::V3>& positions, const math::M4& mvpv, math::V2 viewport)
+	{
+		auto count = positions.count;
+		for (auto v: {&self.clip_x, &self.clip_y, &self.clip_z, &self.clip_w, &self.screen_x, &self.screen_y, &self.screen_z})
+			rc::vec_resize(*v, count);
+		rc::vec_resize(self.outcode, count);
+
+		math::mat4_project_points(mvpv, positions.ptr, count,
+			{self.clip_x.ptr, self.clip_y.ptr, self.clip_z.ptr, self.clip_w.ptr},
+			{self.screen_x.ptr, self.screen_y.ptr, self.screen_z.ptr}
+		);
+
+		for (rc::sz i = 0; i < count; ++i)
+			self.outcode[i] = clip_outcode(vertices_clip(self, i), viewport);
+	}
+
+	enum TRIANGLE_CULL
+	{
+		TRIANGLE_CULL_NONE,
+		// every vertex is outside the same plane of the view frustum
+		TRIANGLE_CULL_FRUSTUM,
+		// clockwise on screen (the viewport flips y so counter clockwise triangles face the camera)
+		TRIANGLE_CULL_BACKFACE,
+		// zero area after snapping, or invalid coordinates
+		TRIANGLE_CULL_DEGENERATE,
+		// covers no pixel center of the canvas
+		TRIANGLE_CULL_EMPTY,
+	};
+
+	// colors are the lit colors of p0, p1 and p2
+	inline static TRIANGLE_CULL
+	triangle_setup(Triangle& self, int width, int height, bool cull_backfaces, const math::Color_F32 (&colors)[3])
+	{
+		for (auto p: {self.p0, self.p1, self.p2})
+			if ((math::abs(p.x) <= GUARD_BAND && math::abs(p.y) <= GUARD_BAND) == false)
+				return TRIANGLE_CULL_DEGENERATE;
+
+		auto x0 = _fixed(self.p0.x), y0 = _fixed(self.p0.y);
+		auto x1 = _fixed(self.p1.x), y1 = _fixed(self.p1.y);
+		auto x2 = _fixed(self.p2.x), y2 = _fixed(self.p2.y);
+
+		// make the winding consistent so that inside is always e >= 0
+		auto area = (x1 - x0) * (y2 - y0) - (y1 - y0) * (x2 - x0);
+		if (area == 0)
+			return TRIANGLE_CULL_DEGENERATE;
+
+		if (area > 0 && cull_backfaces)
+			return TRIANGLE_CULL_BACKFACE;
+
+		// the corners in the order of the vertices after fixing the winding
+		int corners[3] = {0, 1, 2};
+		if (area < 0)
+		{
+			corners[1] = 2;
+			corners[2] = 1;
+			auto p = self.p1;   self.p1 = self.p2;   self.p2 = p;
+			auto uv = self.uv1; self.uv1 = self.uv2; self.uv2 = uv;
+			auto x = x1; x1 = x2; x2 = x;
+			auto y = y1; y1 = y2; y2 = y;
+			area = -area;
+		}
+
+		self.edges[0] = _edge_setup(x1, y1, x2, y2);
+		self.edges[1] = _edge_setup(x2, y2, x0, y0);
+		self.edges[2] = _edge_setup(x0, y0, x1, y1);
+
+		// pixel x is covered if its center (x * 16 + 8) lies inside [min, max]
+		auto min_x = math::min(math::min(x0, x1), x2), max_x = math::max(math::max(x0, x1), x2);
+		auto min_y = math::min(math::min(y0, y1), y2), max_y = math::max(math::max(y0, y1), y2);
+		self.bb_min.x = (int)math::max((min_x - SUBPIXEL_ONE / 2 + SUBPIXEL_ONE - 1) >> SUBPIXEL_BITS, (rc::i64)0);
+		self.bb_min.y = (int)math::max((min_y - SUBPIXEL_ONE / 2 + SUBPIXEL_ONE - 1) >> SUBPIXEL_BITS, (rc::i64)0);
+		self.bb_max.x = (int)math::min((max_x - SUBPIXEL_ONE / 2) >> SUBPIXEL_BITS, (rc::i64)width - 1);
+		self.bb_max.y = (int)math::min((max_y - SUBPIXEL_ONE / 2) >> SUBPIXEL_BITS, (rc::i64)height - 1);
+
+		if (self.bb_min.x > self.bb_max.x || self.bb_min.y > self.bb_max.y)
+			return TRIANGLE_CULL_EMPTY;
+
+		self.z = _plane_setup(self.edges, area, self.bb_min, self.p0.z, self.p1.z, self.p2.z);
+		self.u = _plane_setup(self.edges, area, self.bb_min, self.uv0.x, self.uv1.x, self.uv2.x);
+		self.v = _plane_setup(self.edges, area, self.bb_min, self.uv0.y, self.uv1.y, self.uv2.y);
+
+		// flat colors are kept exact, kernels which don't interpolate only read c
+		auto& c0 = colors[corners[0]];
+		auto& c1 = colors[corners[1]];
+		auto& c2 = colors[corners[2]];
+		if (c0.r == c1.r && c0.r == c2.r && c0.g == c1.g && c0.g == c2.g && c0.b == c1.b && c0.b == c2.b)
+		{
+			self.r = _plane_flat(c0.r);
+			self.g = _plane_flat(c0.g);
+			self.b = _plane_flat(c0.b);
+		}
+		else
+		{
+			self.r = _plane_setup(self.edges, area, self.bb_min, c0.r, c1.r, c2.r);
+			self.g = _plane_setup(self.edges, area, self.bb_min, c0.g, c1.g, c2.g);
+			self.b = _plane_setup(self.edges, area, self.bb_min, c0.b, c1.b, c2.b);
+		}
+		return TRIANGLE_CULL_NONE;
+	}
+
+	// edge functions of a triangle relative to the first pixel of a rect, narrowed to 32-bit so that
+	// they fit in simd lanes, edges which cover the whole rect are dropped (a = b = 0, c = 0)
+	struct Rect_Edges
+	{
+		rc::i32 a[3], b[3], c[3];
+		// pixels the kernel is allowed to touch, and the triangle bounds clipped to them
+		math::V2i rect_min, rect_max;
+		math::V2i min, max;
+		// every covered pixel is closer than the depth buffer so the depth test can be skipped
+		bool depth_pass;
+	};
+
+	enum RECT_COVERAGE
+	{
+		RECT_COVERAGE_NONE,
+		RECT_COVERAGE_PARTIAL,
+		// every pixel in [min, max] is inside the triangle
+		RECT_COVERAGE_FULL,
+		// edge values don't fit in 32-bit, only happens with huge triangles
+		RECT_COVERAGE_OVERFLOW,
+	};
+
+	inline static RECT_COVERAGE
+	triangle_rect_edges(const Triangle& self, math::V2i rect_min, math::V2i rect_max, Rect_Edges& edges)
+	{
+		edges.rect_min = rect_min;
+		edges.rect_max = rect_max;
+		edges.min = math::max(self.bb_min, rect_min);
+		edges.max = math::min(self.bb_max, rect_max);
+		edges.depth_pass = false;
+		if (edges.min.x > edges.max.x || edges.min.y > edges.max.y)
+			return RECT_COVERAGE_NONE;
+
+		auto coverage = RECT_COVERAGE_FULL;
+		for (int i = 0; i < 3; ++i)
+		{
+			auto& e = self.edges[i];
+			auto origin = e.a * edges.min.x + e.b * edges.min.y + e.c + e.bias;
+			auto step_x = e.a * (edges.max.x - edges.min.x);
+			auto step_y = e.b * (edges.max.y - edges.min.y);
+
+			// the edge function is linear so its extremes over the rect are at the corners
+			auto lo = origin + math::min(step_x, (rc::i64)0) + math::min(step_y, (rc::i64)0);
+			auto hi = origin + math::max(step_x, (rc::i64)0) + math::max(step_y, (rc::i64)0);
+			if (hi < 0)
+				return RECT_COVERAGE_NONE;
+
+			if (lo >= 0)
+			{
+				edges.a[i] = 0;
+				edges.b[i] = 0;
+				edges.c[i] = 0;
+				continue;
+			}
+
+			// pixels outside the rect may wrap around in the lanes, they are masked out anyway
+			if (lo < rc::I32_MIN || hi > rc::I32_MAX)
+				coverage = RECT_COVERAGE_OVERFLOW;
+			else if (coverage != RECT_COVERAGE_OVERFLOW)
+				coverage = RECT_COVERAGE_PARTIAL;
+
+			edges.a[i] = (rc::i32)e.a;
+			edges.b[i] = (rc::i32)e.b;
+			edges.c[i] = (rc::i32)origin;
+		}
+
+		return coverage;
+	}
+
+	// per frame counters, while rasterizing each worker counts into its own copy and the copies are
+	// summed at the end of the frame
+	struct Raster_Stats
+	{
+		// input triangles, and the ones crossing the near plane or the guard band
+		rc::u64 triangles_submitted;
+		rc::u64 triangles_clipped;
+		// clipping may split a triangle so the remaining counters are after clipping
+		rc::u64 triangles_culled_frustum;
+		rc::u64 triangles_culled_backface;
+		rc::u64 triangles_culled_degenerate;
+		rc::u64 triangles_culled_empty;
+		rc::u64 triangles_rasterized;
+
+		// triangle parts tested against the coarse depth blocks, and the ones rejected
+		rc::u64 depth_blocks_tested;
+		rc::u64 depth_blocks_culled;
+		// triangles with every block inside a tile rejected
+		rc::u64 depth_triangles_culled;
+
+		// nanoseconds spent copying tiles to the screen
+		rc::u64 blit_ns;
+	};
+
+	inline static void
+	raster_stats_add(Raster_Stats& self, const Raster_Stats& other)
+	{
+		self.triangles_submitted         += other.triangles_submitted;
+		self.triangles_clipped           += other.triangles_clipped;
+		self.triangles_culled_frustum    += other.triangles_culled_frustum;
+		self.triangles_culled_backface   += other.triangles_culled_backface;
+		self.triangles_culled_degenerate += other.triangles_culled_degenerate;
+		self.triangles_culled_empty      += other.triangles_culled_empty;
+		self.triangles_rasterized        += other.triangles_rasterized;
+		self.depth_blocks_tested         += other.depth_blocks_tested;
+		self.depth_blocks_culled         += other.depth_blocks_culled;
+		self.depth_triangles_culled      += other.depth_triangles_culled;
+		self.blit_ns                     += other.blit_ns;
+	}
+
+	// wall time of the frame stages in nanoseconds, tiles are blitted inside the raster pass by every
+	// worker so blit is the average time a worker spent on it and raster is the rest of the pass
+	struct Frame_Timings
+	{
+		rc::u64 vertex_ns;
+		rc::u64 setup_ns;
+		rc::u64 raster_ns;
+		rc::u64 blit_ns;
+	};
+
+	struct Tiles
+	{
+		// indices of the triangles overlapping each tile in submission order
+		rc::Vec<rc::Vec<rc::u32>> bins;
+		int count_x, count_y;
+	};
+
+	inline static Tiles
+	tiles_init()
+	{
+		Tiles self = {};
+		self.bins = rc::vec_init<rc::Vec<rc::u32>>();
+		return self;
+	}
+
+	inline static void
+	tiles_deinit(Tiles& self)
+	{
+		rc::destroy(self.bins);
+		self = {};
+	}
+
+	inline static void
+	tiles_resize(Tiles& self, int width, int height)
+	{
+		self.count_x = (width + TILE_SIZE - 1) / TILE_SIZE;
+		self.count_y = (height + TILE_SIZE - 1) / TILE_SIZE;
+
+		// bins are kept around between frames to reuse their memory
+		rc::sz count = self.count_x * self.count_y;
+		while (self.bins.count < count)
+			rc::vec_push(self.bins, rc::vec_init<rc::u32>());
+
+		for (rc::sz i = 0; i < count; ++i)
+			rc::vec_clear(self.bins[i]);
+	}
+
+	inline static void
+	tiles_bin(Tiles& self, const Triangle& triangle, rc::u32 index)
+	{
+		for (int y = triangle.bb_min.y / TILE_SIZE; y <= triangle.bb_max.y / TILE_SIZE; ++y)
+			for (int x = triangle.bb_min.x / TILE_SIZE; x <= triangle.bb_max.x / TILE_SIZE; ++x)
+				rc::vec_push(self.bins[y * self.count_x + x], index);
+	}
+}
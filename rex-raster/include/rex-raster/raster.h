@@ -0,0 +1,83 @@
+#pragma once
+
+#include "rex-raster/exports.h"
+#include "rex-raster/rex.h"
+#include "rex-raster/shader.h"
+
+#if REX_ARCH_X86
+#include <emmintrin.h>
+#endif
+
+namespace rex::raster
+{
+	// rasterizes the covered pixels of [edges.min, edges.max], kernels only touch pixels inside
+	// [edges.rect_min, edges.rect_max] so a worker can run them on its own tile without synchronization
+	using raster_triangle_proc = void (*)(Rex* self, const Triangle& triangle, const Rect_Edges& edges);
+
+	// every kernel comes in one instance per shader permutation, the tables are indexed by the shader flags
+
+	// uses the 64-bit edges of the triangle, works with any rect
+	REX_RASTER_EXPORT extern const raster_triangle_proc raster_triangle_scalar[SHADER_PERMUTATIONS];
+
+#if REX_ARCH_X86
+	// packs an rgba color in [0, 1] into an opaque Rex_Pixel, truncates like pixel_from_color
+	inline static rc::u32
+	_pixel_pack(__m128 color)
+	{
+		auto i = _mm_cvttps_epi32(_mm_mul_ps(color, _mm_set1_ps(255.0f)));
+		i = _mm_shuffle_epi32(i, _MM_SHUFFLE(3, 0, 1, 2));
+		i = _mm_packs_epi32(i, i);
+		i = _mm_packus_epi16(i, i);
+		return (rc::u32)_mm_cvtsi128_si32(i) | 0xFF000000;
+	}
+
+	// shader_fragment with the color in an sse register, what the resolve pass runs per pixel on x86
+	template <rc::u32 FLAGS>
+	inline static __m128
+	_shader_fragment(const Texture_Sampling& sampling, float u, float v, __m128 color)
+	{
+		if constexpr (Shader<FLAGS>::TEXTURE)
+		{
+			auto texel = texture_sample(sampling, u, v);
+			return _mm_mul_ps(_mm_loadu_ps(&texel.r), color);
+		}
+		else
+		{
+			(void)sampling; (void)u; (void)v;
+			return color;
+		}
+	}
+
+	// 4-wide spans, compiled with -msse4.1
+	REX_RASTER_EXPORT extern const raster_triangle_proc raster_triangle_sse4[SHADER_PERMUTATIONS];
+	// 8-wide spans, compiled with -mavx2
+	REX_RASTER_EXPORT extern const raster_triangle_proc raster_triangle_avx2[SHADER_PERMUTATIONS];
+#endif
+
+	// index of the triangle in the frame, what the visibility buffer stores
+	inline static rc::u32
+	triangle_id(const Rex* self, const Triangle& triangle)
+	{
+		return (rc::u32)(&triangle - self->triangles.ptr);
+	}
+
+	// the uvs are linear over a triangle so the lod, and with it the mip levels, is the same for all its pixels
+	inline static Texture_Sampling
+	triangle_texture_sampling(const Rex* self, const Triangle& triangle)
+	{
+		auto lod = texture_lod(self->texture, triangle.u.dx, triangle.v.dx, triangle.u.dy, triangle.v.dy);
+		return texture_sampling(self->texture, self->sampler, lod);
+	}
+
+	// the shader permutation of the widest kernel supported by the running cpu
+	REX_RASTER_EXPORT raster_triangle_proc raster_triangle_kernel(rc::u32 shader);
+
+	// splits the part of the triangle inside the tile into depth blocks, skips the blocks hidden behind
+	// the depth buffer, rasterizes the rest with the kernel and tightens the block depth bounds. without a
+	// depth test every block is rasterized and the bounds are left alone since the depth isn't written
+	REX_RASTER_EXPORT void raster_triangle(Rex* self, raster_triangle_proc kernel, rc::u32 shader, const Triangle& triangle, math::V2i tile_min, math::V2i tile_max, Raster_Stats& stats);
+
+	// second pass of visibility rendering, runs the fragment stage once on every pixel of the tile the
+	// visibility buffer has a triangle for, the shader must have SHADER_FLAG_VISIBILITY
+	REX_RASTER_EXPORT void raster_resolve(Rex* self, rc::u32 shader, math::V2i tile_min, math::V2i tile_max);
+}
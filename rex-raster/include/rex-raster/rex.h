@@ -3,8 +3,12 @@
 #include "rex-raster/canvas.h"
 #include "rex-raster/mesh.h"
 #include "rex-raster/camera.h"
+#include "rex-raster/pipeline.h"
+#include "rex-raster/shader.h"
+#include "rex-raster/texture.h"
 
 #include <rex-core/api.h>
+#include <rex-core/thread.h>
 
 namespace rex::raster
 {
@@ -13,8 +17,25 @@ namespace rex::raster
 		Canvas canvas;
 		Camera cam;
 		Mesh mesh;
-		// TODO: use image instead of canvas
-		Canvas texture;
+		Texture texture;
+		Sampler sampler;
 		math::Color_F32 mesh_color;
+		// SHADER_FLAG bits picking the permutation of the vertex stage and of the raster kernels
+		rc::u32 shader;
+		// draws the edges of the triangles instead of filling them
+		bool wireframe;
+
+		rc::Thread_Pool* workers;
+		Vertices vertices;
+		rc::Vec<Triangle> triangles;
+		// gouraud shading normals of the mesh positions, rebuilt every frame
+		rc::Vec<math::V3> vertex_normals;
+		Tiles tiles;
+		bool cull_backfaces;
+
+		// counters and timings of the last frame
+		Raster_Stats stats;
+		Frame_Timings timings;
+		rc::Vec<Raster_Stats> worker_stats;
 	};
 }
@@ -0,0 +1,100 @@
+#pragma once
+
+#include "rex-raster/texture.h"
+
+#include <rex-core/types.h>
+#include <rex-math/types.h>
+#include <rex-math/math.h>
+#include <rex-math/vec3.h>
+
+namespace rex::raster
+{
+	// the shading state is a set of flags fixed at compile time, every combination is its own instance of
+	// the vertex stage and of each raster kernel so the per pixel loops never branch on them, the frame
+	// picks its instances from tables indexed by the flags
+	enum SHADER_FLAG: rc::u32
+	{
+		// test and write the depth buffer, without it triangles cover each other in submission order
+		SHADER_FLAG_DEPTH_TEST   = 1 << 0,
+		// multiply the lit color by the texture
+		SHADER_FLAG_TEXTURE      = 1 << 1,
+		// light every vertex and interpolate the colors instead of lighting each face once
+		SHADER_FLAG_GOURAUD      = 1 << 2,
+		// multiply the light by the mesh vertex colors
+		SHADER_FLAG_VERTEX_COLOR = 1 << 3,
+		// rasterize only the depth and the index of the nearest triangle, then shade each visible pixel once
+		// in a resolve pass over the tile, the fragment stage runs there instead of in the raster kernels
+		SHADER_FLAG_VISIBILITY   = 1 << 4,
+
+		SHADER_FLAG_DEFAULT = SHADER_FLAG_DEPTH_TEST | SHADER_FLAG_TEXTURE,
+	};
+
+	static constexpr rc::u32 SHADER_PERMUTATIONS = 1 << 5;
+
+	// the instances of a function template for every permutation, indexed by the flags
+	#define shader_permutations(f) { \
+		f<0>,  f<1>,  f<2>,  f<3>,  f<4>,  f<5>,  f<6>,  f<7>, \
+		f<8>,  f<9>,  f<10>, f<11>, f<12>, f<13>, f<14>, f<15>, \
+		f<16>, f<17>, f<18>, f<19>, f<20>, f<21>, f<22>, f<23>, \
+		f<24>, f<25>, f<26>, f<27>, f<28>, f<29>, f<30>, f<31>, \
+	}
+	static_assert(SHADER_PERMUTATIONS == 32, "shader_permutations lists every permutation");
+
+	template <rc::u32 FLAGS>
+	struct Shader
+	{
+		static constexpr bool DEPTH_TEST   = (FLAGS & SHADER_FLAG_DEPTH_TEST) != 0;
+		static constexpr bool TEXTURE      = (FLAGS & SHADER_FLAG_TEXTURE) != 0;
+		static constexpr bool GOURAUD      = (FLAGS & SHADER_FLAG_GOURAUD) != 0;
+		static constexpr bool VERTEX_COLOR = (FLAGS & SHADER_FLAG_VERTEX_COLOR) != 0;
+		static constexpr bool VISIBILITY   = (FLAGS & SHADER_FLAG_VISIBILITY) != 0;
+		// the color changes over a triangle so the kernels interpolate it per pixel
+		static constexpr bool VARYING_COLOR = GOURAUD || VERTEX_COLOR;
+		// the raster kernels run the fragment stage, otherwise they only write the visibility buffer
+		static constexpr bool RASTER_SHADE = VISIBILITY == false;
+	};
+
+	// lights a vertex, flat shading runs it on each corner with the face normal. a headlight along the
+	// screen z axis, the normal is in screen space and doesn't need to be normalized
+	template <rc::u32 FLAGS>
+	struct Vertex_Shader
+	{
+		math::V3 light_dir;
+
+		math::Color_F32
+		operator()(math::V3 normal, math::Color_F32 color) const
+		{
+			auto intensity = math::dot(math::normalize(normal), light_dir);
+			intensity = math::min(math::max(intensity, 0.0f), 1.0f);
+			if constexpr (Shader<FLAGS>::VERTEX_COLOR)
+				return math::Color_F32{color.r * intensity, color.g * intensity, color.b * intensity, 1.0f};
+			else
+				return math::Color_F32{intensity, intensity, intensity, 1.0f};
+		}
+	};
+
+	// inputs of the fragment stage at a pixel, v already points down the texture
+	struct Fragment
+	{
+		float u, v;
+		math::Color_F32 color;
+	};
+
+	// the fragment stage is a function rather than a functor's member so it keeps internal linkage, the
+	// kernels including it are compiled for different instruction sets and must not share an instance
+	template <rc::u32 FLAGS>
+	inline static math::Color_F32
+	shader_fragment(const Texture_Sampling& sampling, const Fragment& fragment)
+	{
+		if constexpr (Shader<FLAGS>::TEXTURE)
+		{
+			auto texel = texture_sample(sampling, fragment.u, fragment.v);
+			return math::Color_F32{texel.r * fragment.color.r, texel.g * fragment.color.g, texel.b * fragment.color.b, texel.a * fragment.color.a};
+		}
+		else
+		{
+			(void)sampling;
+			return fragment.color;
+		}
+	}
+}
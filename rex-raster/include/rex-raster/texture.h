@@ -0,0 +1,264 @@
+#pragma once
+
+#include "rex-raster/exports.h"
+
+#include <rex-core/vec.h>
+#include <rex-math/types.h>
+
+#include <stdint.h>
+#include <string.h>
+
+namespace rex::raster
+{
+	// a 1x1 last level for textures up to 32768 texels on a side
+	static constexpr int TEXTURE_MAX_LEVELS = 16;
+
+	// tiled levels are stored in TEXTURE_TILE_SIZE x TEXTURE_TILE_SIZE blocks of texels, row major inside a
+	// block and blocks row major in the level, a block is one 64 bytes cache line so a footprint covers the
+	// same few lines whichever direction the uvs run across the texture
+	static constexpr int TEXTURE_TILE_SIZE = 4;
+
+	enum TEXTURE_LAYOUT
+	{
+		TEXTURE_LAYOUT_LINEAR,
+		TEXTURE_LAYOUT_TILED,
+	};
+
+	enum TEXTURE_FILTER
+	{
+		// nearest texel of the closest mip level
+		TEXTURE_FILTER_NEAREST,
+		// 4 texels of the closest mip level
+		TEXTURE_FILTER_BILINEAR,
+		// bilinear samples of the two mip levels around the lod blended together
+		TEXTURE_FILTER_TRILINEAR,
+	};
+
+	enum TEXTURE_WRAP
+	{
+		TEXTURE_WRAP_REPEAT,
+		TEXTURE_WRAP_CLAMP,
+	};
+
+	struct Sampler
+	{
+		TEXTURE_FILTER filter;
+		TEXTURE_WRAP wrap;
+	};
+
+	struct Texel
+	{
+		uint8_t r, g, b, a;
+	};
+
+	struct Texture_Level
+	{
+		const Texel* texels;
+		int width, height;
+		// blocks in a row of a tiled level, the last ones are padded
+		int tiles_x;
+	};
+
+	struct Texture
+	{
+		// every level in one allocation, level 0 first and each next one half the size of the previous, the
+		// levels start on cache line boundaries
+		rc::Vec<Texel> texels;
+		Texture_Level levels[TEXTURE_MAX_LEVELS];
+		int levels_count;
+		TEXTURE_LAYOUT layout;
+	};
+
+	// copies rgba8 rows, top row first, premultiplies them by alpha and builds the mip chain down to 1x1
+	// with a 2x2 box filter
+	REX_RASTER_EXPORT Texture texture_from_rgba8(const uint8_t* data, int width, int height, TEXTURE_LAYOUT layout = TEXTURE_LAYOUT_TILED);
+	REX_RASTER_EXPORT void texture_deinit(Texture& self);
+
+	inline static rc::sz
+	texture_index(const Texture_Level& level, TEXTURE_LAYOUT layout, int x, int y)
+	{
+		if (layout == TEXTURE_LAYOUT_LINEAR)
+			return (rc::sz)y * level.width + x;
+
+		static_assert(TEXTURE_TILE_SIZE == 4, "the shifts and masks assume 4x4 tiles");
+		auto tile = (rc::sz)(y >> 2) * level.tiles_x + (rc::sz)(x >> 2);
+		return tile * 16 + (rc::sz)((y & 3) * 4 + (x & 3));
+	}
+
+	// approximated from the float bits, exact at powers of two and off by less than 0.09 between them
+	inline static float
+	_texture_log2(float x)
+	{
+		uint32_t bits = 0;
+		::memcpy(&bits, &x, sizeof(bits));
+		auto exponent = (float)((int)((bits >> 23) & 0xFF) - 127);
+		bits = (bits & 0x007FFFFF) | 0x3F800000;
+		float mantissa = 0.0f;
+		::memcpy(&mantissa, &bits, sizeof(mantissa));
+		return exponent + mantissa - 1.0f;
+	}
+
+	// log2 of the texels of level 0 a pixel covers given the uv derivatives along the screen axes, negative
+	// when the texture is magnified
+	inline static float
+	texture_lod(const Texture& self, float du_dx, float dv_dx, float du_dy, float dv_dy)
+	{
+		if (self.levels_count == 0)
+			return 0.0f;
+
+		auto width = (float)self.levels[0].width, height = (float)self.levels[0].height;
+		auto x = du_dx * width, y = dv_dx * height;
+		auto rho_x = x * x + y * y;
+		x = du_dy * width;
+		y = dv_dy * height;
+		auto rho_y = x * x + y * y;
+		return 0.5f * _texture_log2(rho_x > rho_y ? rho_x : rho_y);
+	}
+
+	// the levels and weights of a sampler at a fixed lod, set up once per triangle when the lod is constant
+	// over it
+	struct Texture_Sampling
+	{
+		Texture_Level level0, level1;
+		// weight of level1, only trilinear blends
+		float blend;
+		TEXTURE_FILTER filter;
+		TEXTURE_WRAP wrap;
+		TEXTURE_LAYOUT layout;
+	};
+
+	inline static Texture_Sampling
+	texture_sampling(const Texture& self, Sampler sampler, float lod)
+	{
+		Texture_Sampling sampling = {};
+		sampling.filter = sampler.filter;
+		sampling.wrap = sampler.wrap;
+		sampling.layout = self.layout;
+
+		// nan fails both compares and ends up at level 0
+		auto max_lod = (float)(self.levels_count - 1);
+		lod = lod > 0.0f ? lod : 0.0f;
+		lod = lod < max_lod ? lod : max_lod;
+
+		if (sampler.filter == TEXTURE_FILTER_TRILINEAR)
+		{
+			auto level = (int)lod;
+			sampling.level0 = self.levels[level];
+			sampling.level1 = self.levels[level + 1 < self.levels_count ? level + 1 : level];
+			sampling.blend = lod - (float)level;
+		}
+		else
+		{
+			sampling.level0 = self.levels[(int)(lod + 0.5f)];
+			sampling.level1 = sampling.level0;
+		}
+		return sampling;
+	}
+
+	// the wrapped coordinate in [0, 1], repeat keeps the fraction, a fraction rounding up to 1 is the
+	// last texel anyway
+	inline static float
+	_texture_wrap(float t, TEXTURE_WRAP wrap)
+	{
+		if (wrap == TEXTURE_WRAP_CLAMP || (t >= 0.0f && t <= 1.0f))
+			return t > 0.0f ? (t < 1.0f ? t : 1.0f) : 0.0f;
+
+		// out of int range, or nan, there's no fraction left to keep
+		if ((t > -8388608.0f && t < 8388608.0f) == false)
+			return 0.0f;
+		auto i = (float)(int)t;
+		auto fraction = t - (i > t ? i - 1.0f : i);
+		return fraction;
+	}
+
+	inline static math::Color_F32
+	_texel_color(Texel texel)
+	{
+		return math::Color_F32{texel.r / 255.0f, texel.g / 255.0f, texel.b / 255.0f, texel.a / 255.0f};
+	}
+
+	inline static math::Color_F32
+	_texture_nearest(const Texture_Level& level, TEXTURE_LAYOUT layout, float u, float v)
+	{
+		auto x = (int)(u * (float)level.width);
+		auto y = (int)(v * (float)level.height);
+		x = x < level.width ? x : level.width - 1;
+		y = y < level.height ? y : level.height - 1;
+		return _texel_color(level.texels[texture_index(level, layout, x, y)]);
+	}
+
+	inline static math::Color_F32
+	_texture_bilinear(const Texture_Level& level, TEXTURE_WRAP wrap, TEXTURE_LAYOUT layout, float u, float v)
+	{
+		// texel centers are at half coordinates, the 4 texels around the sample are in [-1, size]
+		auto x = u * (float)level.width - 0.5f;
+		auto y = v * (float)level.height - 0.5f;
+		auto x0 = (int)(x + 1.0f) - 1, y0 = (int)(y + 1.0f) - 1;
+		auto fx = x - (float)x0, fy = y - (float)y0;
+		auto x1 = x0 + 1, y1 = y0 + 1;
+
+		if (wrap == TEXTURE_WRAP_CLAMP)
+		{
+			x0 = x0 < 0 ? 0 : x0;
+			y0 = y0 < 0 ? 0 : y0;
+			x1 = x1 < level.width ? x1 : level.width - 1;
+			y1 = y1 < level.height ? y1 : level.height - 1;
+		}
+		else
+		{
+			x0 = x0 < 0 ? level.width - 1 : x0;
+			y0 = y0 < 0 ? level.height - 1 : y0;
+			x1 = x1 < level.width ? x1 : 0;
+			y1 = y1 < level.height ? y1 : 0;
+		}
+
+		Texel texels[4] = {
+			level.texels[texture_index(level, layout, x0, y0)],
+			level.texels[texture_index(level, layout, x1, y0)],
+			level.texels[texture_index(level, layout, x0, y1)],
+			level.texels[texture_index(level, layout, x1, y1)],
+		};
+		float weights[4] = {(1.0f - fx) * (1.0f - fy), fx * (1.0f - fy), (1.0f - fx) * fy, fx * fy};
+
+		float r = 0.0f, g = 0.0f, b = 0.0f, a = 0.0f;
+		for (int i = 0; i < 4; ++i)
+		{
+			r += texels[i].r * weights[i];
+			g += texels[i].g * weights[i];
+			b += texels[i].b * weights[i];
+			a += texels[i].a * weights[i];
+		}
+		return math::Color_F32{r / 255.0f, g / 255.0f, b / 255.0f, a / 255.0f};
+	}
+
+	// u goes right and v goes down from the first texel of the top row
+	inline static math::Color_F32
+	texture_sample(const Texture_Sampling& self, float u, float v)
+	{
+		u = _texture_wrap(u, self.wrap);
+		v = _texture_wrap(v, self.wrap);
+
+		switch (self.filter)
+		{
+			case TEXTURE_FILTER_NEAREST:
+				return _texture_nearest(self.level0, self.layout, u, v);
+			case TEXTURE_FILTER_BILINEAR:
+				return _texture_bilinear(self.level0, self.wrap, self.layout, u, v);
+			case TEXTURE_FILTER_TRILINEAR:
+			{
+				auto c0 = _texture_bilinear(self.level0, self.wrap, self.layout, u, v);
+				if (self.blend == 0.0f)
+					return c0;
+				auto c1 = _texture_bilinear(self.level1, self.wrap, self.layout, u, v);
+				auto t = self.blend;
+				return math::Color_F32{
+					c0.r + (c1.r - c0.r) * t,
+					c0.g + (c1.g - c0.g) * t,
+					c0.b + (c1.b - c0.b) * t,
+					c0.a + (c1.a - c0.a) * t,
+				};
+			}
+		}
+		return {};
+	}
+}
@@ -0,0 +1,650 @@
+#include "rex-raster/gltf.h"
+
+#include <rex-core/json.h>
+#include <rex-core/log.h>
+#include <rex-core/memory.h>
+#include <rex-core/profile.h>
+#include <rex-core/str.h>
+#include <rex-math/mat4.h>
+#include <rex-math/vec3.h>
+
+#include <string.h>
+
+namespace rex::raster
+{
+	// bytes of a buffer or buffer view, stride 0 means tightly packed
+	struct _Gltf_Range
+	{
+		const uint8_t* ptr;
+		rc::sz count;
+		rc::sz stride;
+	};
+
+	inline static uint32_t
+	_gltf_component_size(GLTF_COMPONENT component)
+	{
+		switch (component)
+		{
+			case GLTF_COMPONENT_I8:
+			case GLTF_COMPONENT_U8:  return 1;
+			case GLTF_COMPONENT_I16:
+			case GLTF_COMPONENT_U16: return 2;
+			case GLTF_COMPONENT_U32:
+			case GLTF_COMPONENT_F32: return 4;
+		}
+		return 0;
+	}
+
+	inline static uint32_t
+	_gltf_components(const rc::Json* type)
+	{
+		const char* names[] = {"SCALAR", "VEC2", "VEC3", "VEC4", "MAT2", "MAT3", "MAT4"};
+		uint32_t counts[] = {1, 2, 3, 4, 4, 9, 16};
+		for (int i = 0; i < 7; ++i)
+			if (rc::json_string_equals(type, names[i]))
+				return counts[i];
+		return 0;
+	}
+
+	inline static int32_t
+	_gltf_index(const rc::Json* value)
+	{
+		return (int32_t)rc::json_number(value, -1.0);
+	}
+
+	// glb is a 12 bytes header followed by a json chunk and an optional binary chunk
+	inline static bool
+	_gltf_glb_chunks(const rc::File_Map& file, const char** json_first, const char** json_last, _Gltf_Range& bin)
+	{
+		static constexpr uint32_t CHUNK_JSON = 0x4E4F534A;
+		static constexpr uint32_t CHUNK_BIN = 0x004E4942;
+
+		uint32_t header[3] = {};
+		::memcpy(header, file.ptr, sizeof(header));
+		if (header[1] != 2 || header[2] > file.count)
+			return false;
+
+		rc::sz offset = sizeof(header);
+		bool has_json = false;
+		while (offset + 8 <= header[2])
+		{
+			uint32_t chunk[2] = {};
+			::memcpy(chunk, file.ptr + offset, sizeof(chunk));
+			offset += sizeof(chunk);
+			if (chunk[0] > header[2] - offset)
+				return false;
+
+			if (chunk[1] == CHUNK_JSON && has_json == false)
+			{
+				*json_first = file.ptr + offset;
+				*json_last = file.ptr + offset + chunk[0];
+				has_json = true;
+			}
+			else if (chunk[1] == CHUNK_BIN && bin.ptr == nullptr)
+			{
+				bin.ptr = (const uint8_t*)file.ptr + offset;
+				bin.count = chunk[0];
+			}
+			// chunks are 4 bytes aligned
+			offset += (chunk[0] + 3) & ~3u;
+		}
+		return has_json;
+	}
+
+	inline static int
+	_gltf_hex_digit(char c)
+	{
+		if (c >= '0' && c <= '9')
+			return c - '0';
+		if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+			return (c | 0x20) - 'a' + 10;
+		return -1;
+	}
+
+	// uris are relative to the gltf file and percent encoded inside the json string
+	inline static rc::Str
+	_gltf_uri_path(const char* path, const rc::Json* uri)
+	{
+		rc::sz directory_count = 0;
+		for (rc::sz i = 0; path[i]; ++i)
+			if (path[i] == '/' || path[i] == '\\')
+				directory_count = i + 1;
+
+		// json escapes first, then the percent encoding of the uri
+		auto decoded = rc::json_unescape(*uri, rc::frame_allocator());
+		auto self = rc::str_init(rc::frame_allocator());
+		rc::vec_reserve(self, directory_count + decoded.count + 1);
+		rc::vec_append(self, path, path + directory_count);
+		for (rc::sz i = 0; i < decoded.count; ++i)
+		{
+			auto c = decoded[i];
+			if (c == '%' && i + 2 < decoded.count)
+			{
+				auto high = _gltf_hex_digit(decoded[i + 1]);
+				auto low = _gltf_hex_digit(decoded[i + 2]);
+				if (high >= 0 && low >= 0)
+				{
+					c = (char)(high * 16 + low);
+					i += 2;
+				}
+			}
+			rc::vec_push(self, c);
+		}
+		rc::vec_push(self, '\0');
+		--self.count;
+		return self;
+	}
+
+	inline static bool
+	_gltf_buffers(Gltf& self, const rc::Json* root, const char* path, const _Gltf_Range& glb_bin, _Gltf_Range* buffers)
+	{
+		auto buffers_json = rc::json_find(root, "buffers");
+		for (rc::sz i = 0; i < rc::json_count(buffers_json); ++i)
+		{
+			auto buffer = rc::json_at(buffers_json, i);
+			auto uri = rc::json_find(buffer, "uri");
+			auto length = (rc::sz)rc::json_number(rc::json_find(buffer, "byteLength"), 0.0);
+
+			if (uri == nullptr)
+			{
+				// only the first buffer of a glb may live in its binary chunk
+				if (i != 0 || glb_bin.ptr == nullptr)
+					return false;
+				buffers[i] = glb_bin;
+			}
+			else
+			{
+				if (uri->type != rc::JSON_STRING || (uri->count >= 5 && memcmp(uri->as_string, "data:", 5) == 0))
+				{
+					rex_log_error("[rex-raster]: gltf data uris aren't supported");
+					return false;
+				}
+
+				auto buffer_path = _gltf_uri_path(path, uri);
+				auto map = rc::file_map(buffer_path.ptr);
+				if (map.ptr == nullptr)
+				{
+					rex_log_error("[rex-raster]: failed to load gltf buffer '%s'", buffer_path.ptr);
+					return false;
+				}
+				rc::vec_push(self.files, map);
+				buffers[i] = _Gltf_Range{(const uint8_t*)map.ptr, map.count, 0};
+			}
+
+			if (buffers[i].count < length)
+				return false;
+		}
+		return true;
+	}
+
+	inline static bool
+	_gltf_accessors(Gltf& self, const rc::Json* root, const _Gltf_Range* buffers, rc::sz buffers_count)
+	{
+		auto views_json = rc::json_find(root, "bufferViews");
+		auto views_count = rc::json_count(views_json);
+		auto views = rex_alloc_N_from(rc::frame_allocator(), _Gltf_Range, views_count);
+		for (rc::sz i = 0; i < views_count; ++i)
+		{
+			auto view = rc::json_at(views_json, i);
+			auto buffer = _gltf_index(rc::json_find(view, "buffer"));
+			auto offset = (rc::sz)rc::json_number(rc::json_find(view, "byteOffset"), 0.0);
+			auto length = (rc::sz)rc::json_number(rc::json_find(view, "byteLength"), 0.0);
+			if (buffer < 0 || (rc::sz)buffer >= buffers_count || offset > buffers[buffer].count || length > buffers[buffer].count - offset)
+				return false;
+			views[i] = _Gltf_Range{buffers[buffer].ptr + offset, length, (rc::sz)rc::json_number(rc::json_find(view, "byteStride"), 0.0)};
+		}
+
+		auto accessors_json = rc::json_find(root, "accessors");
+		rc::vec_resize(self.accessors, rc::json_count(accessors_json));
+		for (rc::sz i = 0; i < self.accessors.count; ++i)
+		{
+			auto accessor_json = rc::json_at(accessors_json, i);
+			auto& accessor = self.accessors[i];
+			accessor = {};
+			accessor.component = (GLTF_COMPONENT)rc::json_number(rc::json_find(accessor_json, "componentType"), 0.0);
+			accessor.components = _gltf_components(rc::json_find(accessor_json, "type"));
+			accessor.count = (rc::sz)rc::json_number(rc::json_find(accessor_json, "count"), 0.0);
+			accessor.normalized = rc::json_bool(rc::json_find(accessor_json, "normalized"), false);
+
+			auto element_size = (rc::sz)_gltf_component_size(accessor.component) * accessor.components;
+			if (element_size == 0)
+				return false;
+
+			if (rc::json_find(accessor_json, "sparse"))
+				rex_log_warn("[rex-raster]: gltf sparse accessors aren't supported, accessor %zu uses its dense values", (size_t)i);
+
+			// accessors without a view are all zeros, they are left empty
+			auto view_index = _gltf_index(rc::json_find(accessor_json, "bufferView"));
+			if (view_index < 0)
+			{
+				accessor.count = 0;
+				continue;
+			}
+			if ((rc::sz)view_index >= views_count)
+				return false;
+
+			auto& view = views[view_index];
+			auto offset = (rc::sz)rc::json_number(rc::json_find(accessor_json, "byteOffset"), 0.0);
+			accessor.stride = view.stride ? view.stride : element_size;
+			accessor.ptr = view.ptr + offset;
+			if (accessor.count && (offset > view.count || (accessor.count - 1) * accessor.stride + element_size > view.count - offset))
+				return false;
+		}
+		return true;
+	}
+
+	inline static bool
+	_gltf_meshes(Gltf& self, const rc::Json* root)
+	{
+		auto meshes_json = rc::json_find(root, "meshes");
+		rc::vec_resize(self.meshes, rc::json_count(meshes_json));
+		for (rc::sz i = 0; i < self.meshes.count; ++i)
+		{
+			auto primitives_json = rc::json_find(rc::json_at(meshes_json, i), "primitives");
+			self.meshes[i].first_primitive = (uint32_t)self.primitives.count;
+			self.meshes[i].primitives_count = (uint32_t)rc::json_count(primitives_json);
+			for (rc::sz j = 0; j < rc::json_count(primitives_json); ++j)
+			{
+				auto primitive_json = rc::json_at(primitives_json, j);
+				auto attributes = rc::json_find(primitive_json, "attributes");
+
+				Gltf_Primitive primitive = {};
+				primitive.position = _gltf_index(rc::json_find(attributes, "POSITION"));
+				primitive.normal = _gltf_index(rc::json_find(attributes, "NORMAL"));
+				primitive.uv = _gltf_index(rc::json_find(attributes, "TEXCOORD_0"));
+				primitive.indices = _gltf_index(rc::json_find(primitive_json, "indices"));
+				primitive.material = _gltf_index(rc::json_find(primitive_json, "material"));
+				primitive.mode = (GLTF_MODE)rc::json_number(rc::json_find(primitive_json, "mode"), GLTF_MODE_TRIANGLES);
+
+				for (auto accessor: {primitive.position, primitive.normal, primitive.uv, primitive.indices})
+					if (accessor >= (int32_t)self.accessors.count)
+						return false;
+				rc::vec_push(self.primitives, primitive);
+			}
+		}
+		return true;
+	}
+
+	// local transform of a node from its matrix or its translation, rotation and scale
+	inline static math::M4
+	_gltf_node_transform(const rc::Json* node)
+	{
+		// gltf matrices are column major for column vectors, which is the row major layout for row vectors
+		auto matrix = rc::json_find(node, "matrix");
+		if (rc::json_count(matrix) == 16)
+		{
+			math::M4 self = {};
+			for (int i = 0; i < 16; ++i)
+				self[i / 4][i % 4] = (float)rc::json_number(rc::json_at(matrix, i), 0.0);
+			return self;
+		}
+
+		float t[3] = {0.0f, 0.0f, 0.0f}, r[4] = {0.0f, 0.0f, 0.0f, 1.0f}, s[3] = {1.0f, 1.0f, 1.0f};
+		auto translation = rc::json_find(node, "translation");
+		auto rotation = rc::json_find(node, "rotation");
+		auto scale = rc::json_find(node, "scale");
+		for (int i = 0; i < 3 && rc::json_count(translation) == 3; ++i)
+			t[i] = (float)rc::json_number(rc::json_at(translation, i), t[i]);
+		for (int i = 0; i < 4 && rc::json_count(rotation) == 4; ++i)
+			r[i] = (float)rc::json_number(rc::json_at(rotation, i), r[i]);
+		for (int i = 0; i < 3 && rc::json_count(scale) == 3; ++i)
+			s[i] = (float)rc::json_number(rc::json_at(scale, i), s[i]);
+
+		// scale, then rotate by the unit quaternion, then translate
+		auto x = r[0], y = r[1], z = r[2], w = r[3];
+		return math::M4{
+			s[0] * (1 - 2 * (y * y + z * z)), s[0] * 2 * (x * y + z * w),       s[0] * 2 * (x * z - y * w),       0.0f,
+			s[1] * 2 * (x * y - z * w),       s[1] * (1 - 2 * (x * x + z * z)), s[1] * 2 * (y * z + x * w),       0.0f,
+			s[2] * 2 * (x * z + y * w),       s[2] * 2 * (y * z - x * w),       s[2] * (1 - 2 * (x * x + y * y)), 0.0f,
+			t[0],                             t[1],                             t[2],                             1.0f,
+		};
+	}
+
+	inline static void
+	_gltf_node_instances(Gltf& self, const rc::Json* nodes, int32_t index, const math::M4& parent, bool* visited)
+	{
+		// a valid node graph is a forest so every node is reached once, expanding each node only the first
+		// time keeps cycles and nodes shared by several parents from recursing forever or exponentially
+		auto node = rc::json_at(nodes, (rc::sz)index);
+		if (node == nullptr || visited[index])
+			return;
+		visited[index] = true;
+
+		auto transform = _gltf_node_transform(node) * parent;
+		auto mesh = _gltf_index(rc::json_find(node, "mesh"));
+		if (mesh >= 0 && (rc::sz)mesh < self.meshes.count)
+			rc::vec_push(self.instances, Gltf_Instance{(uint32_t)mesh, transform});
+
+		auto children = rc::json_find(node, "children");
+		for (rc::sz i = 0; i < rc::json_count(children); ++i)
+			_gltf_node_instances(self, nodes, _gltf_index(rc::json_at(children, i)), transform, visited);
+	}
+
+	inline static void
+	_gltf_instances(Gltf& self, const rc::Json* root)
+	{
+		auto nodes = rc::json_find(root, "nodes");
+		auto scenes = rc::json_find(root, "scenes");
+		auto scene = rc::json_at(scenes, (rc::sz)rc::json_number(rc::json_find(root, "scene"), 0.0));
+
+		// without a scene every mesh is shown once where it was modeled
+		if (scene == nullptr)
+		{
+			for (uint32_t i = 0; i < self.meshes.count; ++i)
+				rc::vec_push(self.instances, Gltf_Instance{i, math::mat4_identity<float>()});
+			return;
+		}
+
+		auto visited = rex_alloc_N_from(rc::frame_allocator(), bool, rc::json_count(nodes));
+		::memset(visited, 0, rc::json_count(nodes) * sizeof(*visited));
+
+		auto roots = rc::json_find(scene, "nodes");
+		for (rc::sz i = 0; i < rc::json_count(roots); ++i)
+			_gltf_node_instances(self, nodes, _gltf_index(rc::json_at(roots, i)), math::mat4_identity<float>(), visited);
+	}
+
+	Gltf
+	gltf_from_file(const char* path)
+	{
+		rex_profile_function();
+
+		Gltf self = {};
+		self.accessors = rc::vec_init<Gltf_Accessor>();
+		self.primitives = rc::vec_init<Gltf_Primitive>();
+		self.meshes = rc::vec_init<Gltf_Mesh>();
+		self.instances = rc::vec_init<Gltf_Instance>();
+		self.files = rc::vec_init<rc::File_Map>();
+
+		auto file = rc::file_map(path);
+		if (file.ptr == nullptr)
+		{
+			rex_log_error("[rex-raster]: failed to load gltf file '%s'", path);
+			return self;
+		}
+		rc::vec_push(self.files, file);
+
+		auto json_first = file.ptr, json_last = file.ptr + file.count;
+		_Gltf_Range glb_bin = {};
+		if (file.count >= 12 && memcmp(file.ptr, "glTF", 4) == 0 && _gltf_glb_chunks(file, &json_first, &json_last, glb_bin) == false)
+		{
+			rex_log_error("[rex-raster]: invalid glb file '%s'", path);
+			gltf_deinit(self);
+			return self;
+		}
+
+		auto document = rc::json_parse(json_first, json_last);
+		auto root = document.root;
+		auto buffers_count = rc::json_count(rc::json_find(root, "buffers"));
+		auto buffers = rex_alloc_N_from(rc::frame_allocator(), _Gltf_Range, buffers_count);
+
+		auto valid = root && root->type == rc::JSON_OBJECT &&
+			_gltf_buffers(self, root, path, glb_bin, buffers) &&
+			_gltf_accessors(self, root, buffers, buffers_count) &&
+			_gltf_meshes(self, root);
+		if (valid)
+			_gltf_instances(self, root);
+		rc::json_deinit(document);
+
+		if (valid == false)
+		{
+			rex_log_error("[rex-raster]: invalid gltf file '%s'", path);
+			gltf_deinit(self);
+		}
+		return self;
+	}
+
+	void
+	gltf_deinit(Gltf& self)
+	{
+		for (auto& file: self.files)
+			rc::file_unmap(file);
+		rc::vec_deinit(self.files);
+		rc::vec_deinit(self.instances);
+		rc::vec_deinit(self.meshes);
+		rc::vec_deinit(self.primitives);
+		rc::vec_deinit(self.accessors);
+	}
+
+	void
+	gltf_accessor_read(const Gltf_Accessor& self, rc::sz index, float* values, uint32_t count)
+	{
+		auto element = self.ptr + index * self.stride;
+		for (uint32_t i = 0; i < count; ++i)
+		{
+			if (i >= self.components)
+			{
+				values[i] = 0.0f;
+				continue;
+			}
+
+			// unaligned and possibly strided, read through memcpy
+			switch (self.component)
+			{
+				case GLTF_COMPONENT_I8:
+				{
+					int8_t v; ::memcpy(&v, element + i, sizeof(v));
+					values[i] = self.normalized ? math::max(v / 127.0f, -1.0f) : (float)v;
+					break;
+				}
+				case GLTF_COMPONENT_U8:
+				{
+					uint8_t v; ::memcpy(&v, element + i, sizeof(v));
+					values[i] = self.normalized ? v / 255.0f : (float)v;
+					break;
+				}
+				case GLTF_COMPONENT_I16:
+				{
+					int16_t v; ::memcpy(&v, element + i * 2, sizeof(v));
+					values[i] = self.normalized ? math::max(v / 32767.0f, -1.0f) : (float)v;
+					break;
+				}
+				case GLTF_COMPONENT_U16:
+				{
+					uint16_t v; ::memcpy(&v, element + i * 2, sizeof(v));
+					values[i] = self.normalized ? v / 65535.0f : (float)v;
+					break;
+				}
+				case GLTF_COMPONENT_U32:
+				{
+					uint32_t v; ::memcpy(&v, element + i * 4, sizeof(v));
+					values[i] = (float)v;
+					break;
+				}
+				case GLTF_COMPONENT_F32:
+				{
+					::memcpy(&values[i], element + i * 4, sizeof(float));
+					break;
+				}
+			}
+		}
+	}
+
+	uint32_t
+	gltf_accessor_read_index(const Gltf_Accessor& self, rc::sz index)
+	{
+		auto element = self.ptr + index * self.stride;
+		switch (self.component)
+		{
+			case GLTF_COMPONENT_U8:  { uint8_t v;  ::memcpy(&v, element, sizeof(v)); return v; }
+			case GLTF_COMPONENT_U16: { uint16_t v; ::memcpy(&v, element, sizeof(v)); return v; }
+			case GLTF_COMPONENT_U32: { uint32_t v; ::memcpy(&v, element, sizeof(v)); return v; }
+			case GLTF_COMPONENT_I8:
+			case GLTF_COMPONENT_I16:
+			case GLTF_COMPONENT_F32:
+				break;
+		}
+		return 0;
+	}
+
+	inline static rc::sz
+	_gltf_triangles_count(GLTF_MODE mode, rc::sz count)
+	{
+		switch (mode)
+		{
+			case GLTF_MODE_TRIANGLES: return count / 3;
+			case GLTF_MODE_TRIANGLE_STRIP:
+			case GLTF_MODE_TRIANGLE_FAN: return count >= 3 ? count - 2 : 0;
+			case GLTF_MODE_POINTS:
+			case GLTF_MODE_LINES:
+			case GLTF_MODE_LINE_LOOP:
+			case GLTF_MODE_LINE_STRIP:
+				break;
+		}
+		return 0;
+	}
+
+	// position in the primitive's vertex sequence of a corner of a triangle
+	inline static rc::sz
+	_gltf_triangle_corner(GLTF_MODE mode, rc::sz triangle, int corner)
+	{
+		switch (mode)
+		{
+			case GLTF_MODE_TRIANGLE_STRIP:
+			{
+				// odd triangles swap their first two corners to keep the winding
+				rc::sz odd = triangle & 1;
+				rc::sz strip[3] = {triangle + odd, triangle + 1 - odd, triangle + 2};
+				return strip[corner];
+			}
+			case GLTF_MODE_TRIANGLE_FAN:
+			{
+				rc::sz fan[3] = {triangle + 1, triangle + 2, 0};
+				return fan[corner];
+			}
+			case GLTF_MODE_TRIANGLES:
+			case GLTF_MODE_POINTS:
+			case GLTF_MODE_LINES:
+			case GLTF_MODE_LINE_LOOP:
+			case GLTF_MODE_LINE_STRIP:
+				break;
+		}
+		return triangle * 3 + (rc::sz)corner;
+	}
+
+	Mesh
+	mesh_from_gltf(const char* path)
+	{
+		rex_profile_function();
+
+		auto gltf = gltf_from_file(path);
+
+		Mesh self = mesh_init();
+		self.uv_indices = rc::vec_init<unsigned>();
+
+		// size the mesh once, primitives without triangles or positions are skipped
+		rc::sz vertices_count = 0, indices_count = 0;
+		bool has_normal = false, has_uv = false;
+		for (const auto& instance: gltf.instances)
+		{
+			auto& mesh = gltf.meshes[instance.mesh];
+			for (auto i = mesh.first_primitive; i < mesh.first_primitive + mesh.primitives_count; ++i)
+			{
+				auto& primitive = gltf.primitives[i];
+				if (primitive.position < 0)
+					continue;
+				auto& position = gltf.accessors[primitive.position];
+				auto sequence = primitive.indices >= 0 ? gltf.accessors[primitive.indices].count : position.count;
+				vertices_count += position.count;
+				indices_count += _gltf_triangles_count(primitive.mode, sequence) * 3;
+				has_normal |= primitive.normal >= 0;
+				has_uv |= primitive.uv >= 0;
+			}
+		}
+
+		rc::vec_resize(self.position, vertices_count);
+		rc::vec_resize(self.indices, indices_count);
+		if (has_normal)
+			rc::vec_resize(self.normal, vertices_count);
+		if (has_uv)
+		{
+			rc::vec_resize(self.uv, vertices_count);
+			rc::vec_resize(self.uv_indices, indices_count);
+		}
+
+		rc::sz vertices = 0, indices = 0;
+		for (const auto& instance: gltf.instances)
+		{
+			// normals go through the cofactor matrix which is the inverse transpose scaled by the determinant,
+			// mirroring transforms flip the winding
+			auto& M = instance.transform;
+			math::V3 rows[3] = {M[0].xyz, M[1].xyz, M[2].xyz};
+			math::V3 cofactor[3] = {math::cross(rows[1], rows[2]), math::cross(rows[2], rows[0]), math::cross(rows[0], rows[1])};
+			auto mirrored = math::dot(rows[0], cofactor[0]) < 0.0f;
+
+			auto& mesh = gltf.meshes[instance.mesh];
+			for (auto i = mesh.first_primitive; i < mesh.first_primitive + mesh.primitives_count; ++i)
+			{
+				auto& primitive = gltf.primitives[i];
+				if (primitive.position < 0)
+					continue;
+
+				auto& position = gltf.accessors[primitive.position];
+				auto normal = primitive.normal >= 0 && gltf.accessors[primitive.normal].count == position.count ? &gltf.accessors[primitive.normal] : nullptr;
+				auto uv = primitive.uv >= 0 && gltf.accessors[primitive.uv].count == position.count ? &gltf.accessors[primitive.uv] : nullptr;
+				for (rc::sz j = 0; j < position.count; ++j)
+				{
+					float p[3], n[3] = {}, t[2] = {};
+					gltf_accessor_read(position, j, p, 3);
+					auto world = math::V4{p[0], p[1], p[2], 1.0f} * M;
+					self.position[vertices + j] = world.xyz;
+
+					if (has_normal)
+					{
+						if (normal)
+							gltf_accessor_read(*normal, j, n, 3);
+						auto v = cofactor[0] * n[0] + cofactor[1] * n[1] + cofactor[2] * n[2];
+						self.normal[vertices + j] = normal ? math::normalize(mirrored ? -v : v) : math::V3{};
+					}
+
+					// gltf puts the uv origin at the top left, rex at the bottom left like obj
+					if (has_uv)
+					{
+						if (uv)
+							gltf_accessor_read(*uv, j, t, 2);
+						self.uv[vertices + j] = math::V2{t[0], 1.0f - t[1]};
+					}
+				}
+
+				auto indices_accessor = primitive.indices >= 0 ? &gltf.accessors[primitive.indices] : nullptr;
+				auto sequence = indices_accessor ? indices_accessor->count : position.count;
+				auto triangles = _gltf_triangles_count(primitive.mode, sequence);
+				for (rc::sz j = 0; j < triangles; ++j)
+				{
+					int corners[3] = {0, mirrored ? 2 : 1, mirrored ? 1 : 2};
+					for (auto corner: corners)
+					{
+						auto k = _gltf_triangle_corner(primitive.mode, j, corner);
+						auto index = indices_accessor ? gltf_accessor_read_index(*indices_accessor, k) : (uint32_t)k;
+						if (index >= position.count)
+						{
+							rex_log_error("[rex-raster]: gltf index %u is out of range of the %zu vertices in '%s'", index, (size_t)position.count, path);
+							mesh_deinit(self);
+							gltf_deinit(gltf);
+							return self;
+						}
+						self.indices[indices] = (unsigned)(vertices + index);
+						if (has_uv)
+							self.uv_indices[indices] = (unsigned)(vertices + index);
+						++indices;
+					}
+				}
+
+				vertices += position.count;
+			}
+		}
+
+		if (self.position.count)
+		{
+			self.bb_min = self.position[0];
+			self.bb_max = self.position[0];
+			for (auto p: self.position)
+			{
+				self.bb_min = math::min(self.bb_min, p);
+				self.bb_max = math::max(self.bb_max, p);
+			}
+		}
+
+		gltf_deinit(gltf);
+		return self;
+	}
+}
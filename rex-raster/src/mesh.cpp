@@ -1,15 +1,17 @@
 #include "rex-raster/mesh.h"
+#include "rex-raster/gltf.h"
 
 #include <rex-core/file.h>
 #include <rex-core/log.h>
 #include <rex-core/assert.h>
+#include <rex-core/defer.h>
+#include <rex-core/profile.h>
+#include <rex-core/memory.h>
 #include <rex-math/vec3.h>
 
 #include <stdint.h>
-
-#if 0
-# include "rex-raster/gltf.h"
-#endif
+#include <stdio.h>
+#include <string.h>
 
 namespace rex::raster
 {
@@ -50,6 +52,7 @@ namespace rex::raster
 		rc::vec_deinit(self.uv);
 		rc::vec_deinit(self.indices);
 		rc::vec_deinit(self.uv_indices);
+		rc::file_unmap(self.storage);
 		self = {};
 	}
 
@@ -270,21 +273,29 @@ namespace rex::raster
 	Mesh
 	mesh_from_stl(const char* path)
 	{
+		rex_profile_function();
+
 		Mesh self = {};
 
-		auto content = rc::file_read(path, rc::frame_allocator());
+		auto content = rc::file_map(path);
 		if (content.ptr == nullptr)
 		{
 			rex_log_error("[rex-raster]: failed to load stl file '%s'", path);
 			return self;
 		}
+		rex_defer(rc::file_unmap(content));
 
-		auto ptr = content.ptr;
-		// skip header (80 bytes)
-		ptr += 80;
-		// number of triangles (4 bytes)
-		uint32_t triangles_number = *(uint32_t*)ptr;
-		ptr += 4;
+		// 80 bytes header, triangles count (4 bytes) then 50 bytes per triangle
+		uint32_t triangles_number = 0;
+		if (content.count >= 84)
+			::memcpy(&triangles_number, content.ptr + 80, sizeof(triangles_number));
+		if (content.count < 84 || content.count - 84 < (rc::sz)triangles_number * 50)
+		{
+			rex_log_error("[rex-raster]: truncated stl file '%s'", path);
+			return self;
+		}
+
+		auto ptr = content.ptr + 84;
 		// allocate data
 		self.position = rc::vec_with_count<math::V3>(triangles_number * 3);
 		self.normal = rc::vec_with_count<math::V3>(triangles_number * 3);
@@ -296,16 +307,16 @@ namespace rex::raster
 		for (uint32_t i = 0; i < triangles_number; ++i)
 		{
 			// copy triangle normal (12 bytes)
-			self.normal[i*3 + 0] = *(math::V3*)ptr;
-			self.normal[i*3 + 1] = *(math::V3*)ptr;
-			self.normal[i*3 + 2] = *(math::V3*)ptr;
+			self.normal[i*3 + 0] = *(const math::V3*)ptr;
+			self.normal[i*3 + 1] = *(const math::V3*)ptr;
+			self.normal[i*3 + 2] = *(const math::V3*)ptr;
 			ptr += 12;
 			// copy 3 triangle vertices (12 bytes each)
-			self.position[i*3 + 0] = *(math::V3*)ptr;
+			self.position[i*3 + 0] = *(const math::V3*)ptr;
 			ptr += 12;
-			self.position[i*3 + 1] = *(math::V3*)ptr;
+			self.position[i*3 + 1] = *(const math::V3*)ptr;
 			ptr += 12;
-			self.position[i*3 + 2] = *(math::V3*)ptr;
+			self.position[i*3 + 2] = *(const math::V3*)ptr;
 			ptr += 12;
 			// skip attribute byt count (2 bytes)
 			ptr += 2;
@@ -316,9 +327,302 @@ namespace rex::raster
 		return self;
 	}
 
+	// cursor over the obj text, tokens are views into the file buffer so parsing never copies
+	struct _Obj_Cursor
+	{
+		const char* it;
+		const char* end;
+	};
+
+	inline static bool
+	_obj_is_space(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+
+	inline static void
+	_obj_skip_spaces(_Obj_Cursor& self)
+	{
+		while (self.it < self.end && _obj_is_space(*self.it))
+			++self.it;
+	}
+
+	inline static void
+	_obj_skip_line(_Obj_Cursor& self)
+	{
+		while (self.it < self.end && *self.it != '\n')
+			++self.it;
+		if (self.it < self.end)
+			++self.it;
+	}
+
+	// next token on the current line, empty at the end of the line
+	inline static rc::Str
+	_obj_token(_Obj_Cursor& self)
+	{
+		_obj_skip_spaces(self);
+
+		rc::Str token = {};
+		token.ptr = (char*)self.it;
+		while (self.it < self.end && _obj_is_space(*self.it) == false && *self.it != '\n')
+			++self.it;
+		token.count = (rc::sz)(self.it - token.ptr);
+		token.capacity = token.count;
+		return token;
+	}
+
+	// false when the next token isn't a number
+	inline static bool
+	_obj_float(_Obj_Cursor& self, float* value)
+	{
+		_obj_skip_spaces(self);
+		double number = 0.0;
+		auto count = rc::str_parse_double(self.it, self.end, &number);
+		self.it += count;
+		*value = (float)number;
+		return count != 0 && (self.it == self.end || _obj_is_space(*self.it) || *self.it == '\n');
+	}
+
+	// obj indices start at 1, negative ones are relative to the end of the list read so far. false when the
+	// index is malformed or outside the total records of the file
+	inline static bool
+	_obj_index(const char* first, const char* last, rc::sz count, rc::sz total, unsigned* index)
+	{
+		int64_t value = 0;
+		auto consumed = rc::str_parse_int(first, last, &value);
+		if (first == last || consumed != (rc::sz)(last - first) || value == 0)
+			return false;
+		auto resolved = value > 0 ? value - 1 : (rc::i64)count + value;
+		*index = (unsigned)resolved;
+		return resolved >= 0 && resolved < (rc::i64)total;
+	}
+
+	// kind of the record starting at the cursor, the cursor is moved past the keyword
+	enum OBJ_RECORD
+	{
+		OBJ_RECORD_NONE,
+		OBJ_RECORD_POSITION,
+		OBJ_RECORD_UV,
+		OBJ_RECORD_NORMAL,
+		OBJ_RECORD_FACE,
+	};
+
+	inline static OBJ_RECORD
+	_obj_record(_Obj_Cursor& self)
+	{
+		_obj_skip_spaces(self);
+		auto keyword = _obj_token(self);
+		if (keyword.count == 1 && keyword[0] == 'v')
+			return OBJ_RECORD_POSITION;
+		if (keyword.count == 2 && keyword[0] == 'v' && keyword[1] == 't')
+			return OBJ_RECORD_UV;
+		if (keyword.count == 2 && keyword[0] == 'v' && keyword[1] == 'n')
+			return OBJ_RECORD_NORMAL;
+		if (keyword.count == 1 && keyword[0] == 'f')
+			return OBJ_RECORD_FACE;
+		return OBJ_RECORD_NONE;
+	}
+
+	// a face corner is v, v/vt, v//vn or v/vt/vn
+	inline static bool
+	_obj_corner_has_uv(const rc::Str& token)
+	{
+		auto it = token.ptr, end = token.ptr + token.count;
+		while (it < end && *it != '/')
+			++it;
+		return it + 1 < end && it[1] != '/';
+	}
+
+	// a run of whole lines, its record counts become the offsets it writes at once they're prefix summed.
+	// uv_corners only counts, uv_indices line up with indices so they share its offsets
+	struct _Obj_Chunk
+	{
+		const char* first;
+		const char* last;
+		rc::sz positions, uvs, normals, indices, uv_corners;
+		// start of the first malformed line, null when the chunk parsed
+		const char* error;
+	};
+
+	// positions and uvs are the totals of the file, indices are checked against them
+	struct _Obj_Job
+	{
+		_Obj_Chunk* chunks;
+		Mesh* mesh;
+		rc::sz positions, uvs;
+	};
+
+	inline static void
+	_obj_chunk_count(_Obj_Chunk& self)
+	{
+		self.positions = self.uvs = self.normals = self.indices = self.uv_corners = 0;
+		for (_Obj_Cursor cursor = {self.first, self.last}; cursor.it < cursor.end; _obj_skip_line(cursor))
+		{
+			switch (_obj_record(cursor))
+			{
+				case OBJ_RECORD_POSITION: ++self.positions; break;
+				case OBJ_RECORD_UV: ++self.uvs; break;
+				case OBJ_RECORD_NORMAL: ++self.normals; break;
+				case OBJ_RECORD_FACE:
+				{
+					// polygons are split into a fan, every corner past the second adds a triangle
+					int corner = 0;
+					bool has_uv = true;
+					for (auto token = _obj_token(cursor); token.count; token = _obj_token(cursor), ++corner)
+						has_uv = has_uv && _obj_corner_has_uv(token);
+					if (corner >= 3)
+					{
+						self.indices += (corner - 2) * 3;
+						if (has_uv)
+							self.uv_corners += (corner - 2) * 3;
+					}
+					break;
+				}
+				case OBJ_RECORD_NONE: break;
+			}
+		}
+	}
+
+	// writes the chunk's records at its offsets into the already sized mesh vectors. when some faces have
+	// uvs, corners without one use the default uv appended after the file's ones. returns the start of the
+	// first malformed line, or null
+	inline static const char*
+	_obj_chunk_parse(const _Obj_Chunk& self, const _Obj_Job& job)
+	{
+		auto& mesh = *job.mesh;
+		auto positions = self.positions, uvs = self.uvs, normals = self.normals, indices = self.indices;
+		auto uv_default = (unsigned)job.uvs;
+		for (_Obj_Cursor cursor = {self.first, self.last}; cursor.it < cursor.end; _obj_skip_line(cursor))
+		{
+			auto line = cursor.it;
+			switch (_obj_record(cursor))
+			{
+				case OBJ_RECORD_POSITION:
+				{
+					math::V3 v = {};
+					if (_obj_float(cursor, &v.x) == false || _obj_float(cursor, &v.y) == false || _obj_float(cursor, &v.z) == false)
+						return line;
+					mesh.position[positions++] = v;
+					break;
+				}
+				case OBJ_RECORD_UV:
+				{
+					// the second coordinate is optional
+					math::V2 v = {};
+					if (_obj_float(cursor, &v.x) == false)
+						return line;
+					_obj_skip_spaces(cursor);
+					if (cursor.it < cursor.end && *cursor.it != '\n' && _obj_float(cursor, &v.y) == false)
+						return line;
+					mesh.uv[uvs++] = v;
+					break;
+				}
+				case OBJ_RECORD_NORMAL:
+				{
+					math::V3 v = {};
+					if (_obj_float(cursor, &v.x) == false || _obj_float(cursor, &v.y) == false || _obj_float(cursor, &v.z) == false)
+						return line;
+					mesh.normal[normals++] = v;
+					break;
+				}
+				case OBJ_RECORD_FACE:
+				{
+					// polygons are split into a fan around their first vertex
+					unsigned first[2] = {}, prev[2] = {};
+					int corner = 0;
+					for (auto token = _obj_token(cursor); token.count; token = _obj_token(cursor), ++corner)
+					{
+						auto it = token.ptr, end = token.ptr + token.count;
+						auto slash = it;
+						while (slash < end && *slash != '/')
+							++slash;
+
+						// relative indices count from the records before this line in the whole file
+						unsigned index[2] = {0, uv_default};
+						if (_obj_index(it, slash, positions, job.positions, &index[0]) == false)
+							return line;
+						if (_obj_corner_has_uv(token))
+						{
+							auto uv_end = slash + 1;
+							while (uv_end < end && *uv_end != '/')
+								++uv_end;
+							if (_obj_index(slash + 1, uv_end, uvs, job.uvs, &index[1]) == false)
+								return line;
+						}
+
+						if (corner >= 2)
+						{
+							unsigned triangle[3][2] = {{first[0], first[1]}, {prev[0], prev[1]}, {index[0], index[1]}};
+							for (auto& vertex: triangle)
+							{
+								if (mesh.uv_indices.count)
+									mesh.uv_indices[indices] = vertex[1];
+								mesh.indices[indices++] = vertex[0];
+							}
+						}
+
+						if (corner == 0)
+						{
+							first[0] = index[0];
+							first[1] = index[1];
+						}
+						prev[0] = index[0];
+						prev[1] = index[1];
+					}
+					if (corner < 3)
+						return line;
+					break;
+				}
+				case OBJ_RECORD_NONE:
+					break;
+			}
+		}
+		return nullptr;
+	}
+
+	inline static void
+	_obj_count_task(void* user_data, uint32_t index, uint32_t)
+	{
+		rex_profile_zone("obj_count");
+		auto job = (_Obj_Job*)user_data;
+		_obj_chunk_count(job->chunks[index]);
+	}
+
+	inline static void
+	_obj_parse_task(void* user_data, uint32_t index, uint32_t)
+	{
+		rex_profile_zone("obj_parse");
+		auto job = (_Obj_Job*)user_data;
+		job->chunks[index].error = _obj_chunk_parse(job->chunks[index], *job);
+	}
+
+	inline static void
+	_obj_run(rc::Thread_Pool* workers, uint32_t count, rc::task_proc_t proc, _Obj_Job& job)
+	{
+		if (workers && count > 1)
+			rc::thread_pool_run(workers, count, proc, &job);
+		else
+			for (uint32_t i = 0; i < count; ++i)
+				proc(&job, i, 0);
+	}
+
+	inline static void
+	_obj_prefix_sum(rc::sz& value, rc::sz& total)
+	{
+		auto count = value;
+		value = total;
+		total += count;
+	}
+
 	Mesh
-	mesh_from_obj(const char* path)
+	mesh_from_obj(const char* path, rc::Thread_Pool* workers)
 	{
+		rex_profile_function();
+
+		// chunks smaller than this aren't worth a task
+		static constexpr rc::sz OBJ_CHUNK_MIN_SIZE = 1 << 20;
+		static constexpr uint32_t OBJ_CHUNKS_PER_WORKER = 4;
+
 		Mesh self = {};
 		self.position = rc::vec_init<math::V3>();
 		self.uv = rc::vec_init<math::V2>();
@@ -326,71 +630,82 @@ namespace rex::raster
 		self.indices = rc::vec_init<unsigned>();
 		self.uv_indices = rc::vec_init<unsigned>();
 
-		auto content = rc::file_read(path, rc::frame_allocator());
+		auto content = rc::file_map(path);
 		if (content.ptr == nullptr)
 		{
 			rex_log_error("[rex-raster]: failed to load obj file '%s'", path);
 			return self;
 		}
+		rex_defer(rc::file_unmap(content));
 
-		auto lines = rc::str_lines(content, rc::frame_allocator());
-		for (const auto& line: lines)
+		// split at line starts, a few chunks per worker so uneven ones still balance
+		uint32_t chunks_count = 1;
+		if (workers && rc::thread_pool_workers_count(workers) > 1)
 		{
-			// skip empty lines
-			if (line.count == 0)
-				continue;
-
-			// skip comments
-			if (line[0] == '#')
-				continue;
+			auto by_size = content.count / OBJ_CHUNK_MIN_SIZE;
+			auto by_workers = (rc::sz)rc::thread_pool_workers_count(workers) * OBJ_CHUNKS_PER_WORKER;
+			chunks_count = (uint32_t)(by_size < by_workers ? (by_size ? by_size : 1) : by_workers);
+		}
 
-			bool result = false;
-			auto splits = rc::str_split(line, ' ', rc::frame_allocator());
-			if (splits[0] == "v")
-			{
-				rex_assert(splits.count == 4);
-				math::V3 v = {};
-				v.x = (float)rc::str_to_double(splits[1], &result); rex_assert(result);
-				v.y = (float)rc::str_to_double(splits[2], &result); rex_assert(result);
-				v.z = (float)rc::str_to_double(splits[3], &result); rex_assert(result);
-				rc::vec_push(self.position, v);
-			}
-			else if (splits[0] == "vt")
-			{
-				rex_assert(splits.count == 3 || splits.count == 4);
-				math::V2 v = {};
-				v.x = (float)rc::str_to_double(splits[1], &result); rex_assert(result);
-				v.y = (float)rc::str_to_double(splits[2], &result); rex_assert(result);
-				rc::vec_push(self.uv, v);
-			}
-			else if (splits[0] == "vn")
-			{
-				rex_assert(splits.count == 4);
-				math::V3 v = {};
-				v.x = (float)rc::str_to_double(splits[1], &result); rex_assert(result);
-				v.y = (float)rc::str_to_double(splits[2], &result); rex_assert(result);
-				v.z = (float)rc::str_to_double(splits[3], &result); rex_assert(result);
-				rc::vec_push(self.normal, v);
-			}
-			else if (splits[0] == "f")
+		auto chunks = rex_alloc_N_from(rc::frame_allocator(), _Obj_Chunk, chunks_count);
+		auto end = content.ptr + content.count;
+		const char* first = content.ptr;
+		for (uint32_t i = 0; i < chunks_count; ++i)
+		{
+			const char* last = end;
+			if (i + 1 < chunks_count)
 			{
-				for (rc::sz i = 1; i < splits.count; ++i)
-				{
-					auto indices = rc::str_split(splits[i], '/', rc::frame_allocator());
-					unsigned idx = (unsigned)rc::str_to_int(indices[0], &result) - 1; rex_assert(result);
-					rc::vec_push(self.indices, idx);
-					if (indices.count > 1)
-					{
-						unsigned uv_idx = (unsigned)rc::str_to_int(indices[1], &result) - 1; rex_assert(result);
-						rc::vec_push(self.uv_indices, uv_idx);
-					}
-				}
+				last = content.ptr + content.count / chunks_count * (i + 1);
+				if (last < first)
+					last = first;
+				while (last < end && last[-1] != '\n')
+					++last;
 			}
-			else
-			{
+			chunks[i] = _Obj_Chunk{first, last, 0, 0, 0, 0, 0, nullptr};
+			first = last;
+		}
+
+		_Obj_Job job = {chunks, &self, 0, 0};
+		_obj_run(workers, chunks_count, _obj_count_task, job);
+
+		// every vector is sized once and each chunk writes its own range of it
+		rc::sz positions = 0, uvs = 0, normals = 0, indices = 0, uv_corners = 0;
+		for (uint32_t i = 0; i < chunks_count; ++i)
+		{
+			_obj_prefix_sum(chunks[i].positions, positions);
+			_obj_prefix_sum(chunks[i].uvs, uvs);
+			_obj_prefix_sum(chunks[i].normals, normals);
+			_obj_prefix_sum(chunks[i].indices, indices);
+			uv_corners += chunks[i].uv_corners;
+		}
+		rc::vec_resize(self.position, positions);
+		rc::vec_resize(self.normal, normals);
+		rc::vec_resize(self.indices, indices);
+
+		// uv_indices are either empty or one per index, faces without uvs get the middle of the texture like
+		// meshes without any
+		auto uv_default = uv_corners && uv_corners < indices;
+		rc::vec_resize(self.uv, uvs + (uv_default ? 1 : 0));
+		if (uv_default)
+			self.uv[uvs] = math::V2{0.5f, 0.5f};
+		if (uv_corners)
+			rc::vec_resize(self.uv_indices, indices);
+
+		job.positions = positions;
+		job.uvs = uvs;
+		_obj_run(workers, chunks_count, _obj_parse_task, job);
+
+		// the first bad line of the file, a mesh with indices out of its vertices would crash whoever uses it
+		for (uint32_t i = 0; i < chunks_count; ++i)
+		{
+			if (chunks[i].error == nullptr)
 				continue;
-				// rex_assert(false);
-			}
+			rc::sz line = 1;
+			for (auto it = content.ptr; it < chunks[i].error; ++it)
+				line += *it == '\n';
+			rex_log_error("[rex-raster]: invalid obj file '%s' at line %zu", path, (size_t)line);
+			mesh_deinit(self);
+			return self;
 		}
 
 		_mesh_bounding_box(self);
@@ -398,102 +713,223 @@ namespace rex::raster
 		return self;
 	}
 
-#if 0
-	Mesh
-	mesh_from_gltf(const char* path)
+	// little endian header followed by the arrays in REXMESH_ARRAY order, each at an aligned offset. bump
+	// the version whenever the layout changes so older files are rejected and caches rebuilt
+	static constexpr uint32_t REXMESH_MAGIC = 0x48534D52; // "RMSH"
+	static constexpr uint32_t REXMESH_VERSION = 1;
+	static constexpr uint64_t REXMESH_ALIGNMENT = 16;
+
+	enum REXMESH_ARRAY
 	{
-		auto gltf = gltf_load(self);
-		{
-			const char* image_path = "";
-			for (int i = 0; i < gltf.root.as_object.length; ++i)
-			{
-				if (str_eq(gltf.root.as_object.members[i].name, "images"))
-				{
-					image_path = gltf.root.as_object.members[i].value.as_array.values[0].as_object.members[0].value.as_str;
-					break;
-				}
-			}
-			image_path = str_concat("data/girl/", image_path);
+		REXMESH_ARRAY_POSITION,
+		REXMESH_ARRAY_NORMAL,
+		REXMESH_ARRAY_UV,
+		REXMESH_ARRAY_COLOR,
+		REXMESH_ARRAY_INDICES,
+		REXMESH_ARRAY_UV_INDICES,
+		REXMESH_ARRAY_COUNT,
+	};
+
+	struct _Rexmesh_Array
+	{
+		uint64_t offset;
+		uint64_t count;
+	};
 
-			// load image file
-			int width, height, channels;
-			unsigned char* data = stbi_load(image_path, &width, &height, &channels, 4);
+	struct _Rexmesh_Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t source_size;
+		int64_t source_modified_ns;
+		math::V3 bb_min;
+		math::V3 bb_max;
+		_Rexmesh_Array arrays[REXMESH_ARRAY_COUNT];
+	};
+	static_assert(sizeof(_Rexmesh_Header) == 144, "the header layout is part of the file format");
+
+	template <typename T>
+	inline static void
+	_rexmesh_layout(_Rexmesh_Array& self, const rc::Vec<T>& values, uint64_t& offset)
+	{
+		offset = (offset + REXMESH_ALIGNMENT - 1) & ~(REXMESH_ALIGNMENT - 1);
+		self.offset = offset;
+		self.count = values.count;
+		offset += values.count * sizeof(T);
+	}
 
-			self->image.pixels = rex_alloc_N(Pixel, width * height);
-			self->image.width = width;
-			self->image.height = height;
+	template <typename T>
+	inline static bool
+	_rexmesh_write(FILE* file, const _Rexmesh_Array& array, const rc::Vec<T>& values, uint64_t& position)
+	{
+		// zero padding up to the aligned offset, position counts the bytes written so far since ftell is
+		// only 32-bit on windows
+		static constexpr char PADDING[REXMESH_ALIGNMENT] = {};
+		if (position < array.offset && fwrite(PADDING, 1, array.offset - position, file) != array.offset - position)
+			return false;
+		if (values.count && fwrite(values.ptr, sizeof(T), values.count, file) != values.count)
+			return false;
+		position = array.offset + values.count * sizeof(T);
+		return true;
+	}
 
-			for (int i = 0; i < width * height; ++i)
-			{
-				self->image.pixels[i].r = data[i*4 + 0] / 255.0f;
-				self->image.pixels[i].g = data[i*4 + 1] / 255.0f;
-				self->image.pixels[i].b = data[i*4 + 2] / 255.0f;
-				self->image.pixels[i].a = data[i*4 + 3] / 255.0f;
-			}
+	// the vector points into the mapping and doesn't own it, a null allocator makes vec_deinit skip it
+	template <typename T>
+	inline static bool
+	_rexmesh_view(rc::Vec<T>& self, const _Rexmesh_Array& array, const rc::File_Map& map)
+	{
+		if (array.offset % REXMESH_ALIGNMENT || array.offset > map.count || array.count > (map.count - array.offset) / sizeof(T))
+			return false;
 
-			stbi_image_free(data);
+		self = {};
+		self.ptr = (T*)(map.ptr + array.offset);
+		self.count = array.count;
+		self.capacity = array.count;
+		return true;
+	}
 
-			{
-				auto buffer = json_find(gltf.root, "buffers").as_array.values[0];
-				auto buffer_length = json_find(buffer, "byteLength").as_int;
-				auto buffer_uri = json_find(buffer, "uri").as_str;
-
-				auto bin_content = rc::file_read(str_concat("data/girl/", buffer_uri));
-				assert(bin_content.count == buffer_length);
-
-				// load only first mesh
-				auto meshes = json_find(gltf.root, "meshes");
-				auto mesh0 = meshes.as_array.values[0];
-				auto primitive = json_find(mesh0, "primitives").as_array.values[0];
-				auto attributes = json_find(primitive, "attributes");
-
-				auto position_attr = json_find(attributes, "POSITION").as_int;
-				auto normal_attr = json_find(attributes, "NORMAL").as_int;
-				auto uv_attr = json_find(attributes, "TEXCOORD_0").as_int;
-				auto indices_attr = json_find(primitive, "indices").as_int;
-
-				auto accessors = json_find(gltf.root, "accessors");
-				auto position_acc = accessors.as_array.values[position_attr];
-				auto normal_acc = accessors.as_array.values[normal_attr];
-				auto uv_acc = accessors.as_array.values[uv_attr];
-				auto indices_acc = accessors.as_array.values[indices_attr];
-
-				auto position_count = json_find(position_acc, "count").as_int;
-				auto normal_count = json_find(normal_acc, "count").as_int;
-				auto uv_count = json_find(uv_acc, "count").as_int;
-				auto indices_count = json_find(indices_acc, "count").as_int;
-
-				assert(position_count == normal_count && normal_count == uv_count);
-				self->vertices_count = (unsigned int)position_count;
-				self->indices_count = (unsigned int)indices_count;
-
-				auto position_offset = json_find(position_acc, "byteOffset").as_int;
-				auto normal_offset = json_find(normal_acc, "byteOffset").as_int;
-				auto uv_offset = json_find(uv_acc, "byteOffset").as_int;
-				auto indices_offset = json_find(indices_acc, "byteOffset").as_int;
-
-				auto position_view_index = json_find(position_acc, "bufferView").as_int;
-				auto normal_view_index = json_find(normal_acc, "bufferView").as_int;
-				auto uv_view_index = json_find(uv_acc, "bufferView").as_int;
-				auto indices_view_index = json_find(indices_acc, "bufferView").as_int;
-
-				auto bufferViews = json_find(gltf.root, "bufferViews");
-				auto position_view = bufferViews.as_array.values[position_view_index];
-				auto normal_view = bufferViews.as_array.values[normal_view_index];
-				auto uv_view = bufferViews.as_array.values[uv_view_index];
-				auto indices_view = bufferViews.as_array.values[indices_view_index];
-
-				position_offset += json_find(position_view, "byteOffset").as_int;
-				normal_offset += json_find(normal_view, "byteOffset").as_int;
-				uv_offset += json_find(uv_view, "byteOffset").as_int;
-				indices_offset += json_find(indices_view, "byteOffset").as_int;
-
-				self->vertices = (Vec3*)(bin_content.ptr + position_offset);
-				self->normals = (Vec3*)(bin_content.ptr + normal_offset);
-				self->uvs = (Vec2*)(bin_content.ptr + uv_offset);
-				self->indices = (unsigned int*)(bin_content.ptr + indices_offset);
-			}
+	// every index must be below count, one pass over the mapping the compiler can vectorize
+	inline static bool
+	_rexmesh_indices_valid(const rc::Vec<unsigned>& indices, rc::sz count)
+	{
+		unsigned max = 0;
+		for (auto index: indices)
+			max = index > max ? index : max;
+		return indices.count == 0 || max < count;
+	}
+
+	// source null accepts any file, otherwise it must have been converted from a file of that size and time
+	inline static bool
+	_mesh_from_rexmesh(const char* path, const rc::File_Info* source, Mesh& self)
+	{
+		auto map = rc::file_map(path);
+		if (map.ptr == nullptr)
+			return false;
+
+		_Rexmesh_Header header = {};
+		if (map.count >= sizeof(header))
+			::memcpy(&header, map.ptr, sizeof(header));
+
+		auto valid = map.count >= sizeof(header) && header.magic == REXMESH_MAGIC && header.version == REXMESH_VERSION;
+		if (valid && source)
+			valid = header.source_size == source->size && header.source_modified_ns == source->modified_ns;
+
+		Mesh mesh = {};
+		valid = valid &&
+			_rexmesh_view(mesh.position, header.arrays[REXMESH_ARRAY_POSITION], map) &&
+			_rexmesh_view(mesh.normal, header.arrays[REXMESH_ARRAY_NORMAL], map) &&
+			_rexmesh_view(mesh.uv, header.arrays[REXMESH_ARRAY_UV], map) &&
+			_rexmesh_view(mesh.color, header.arrays[REXMESH_ARRAY_COLOR], map) &&
+			_rexmesh_view(mesh.indices, header.arrays[REXMESH_ARRAY_INDICES], map) &&
+			_rexmesh_view(mesh.uv_indices, header.arrays[REXMESH_ARRAY_UV_INDICES], map);
+
+		// the arrays are used in place and the renderer doesn't check the indices, a corrupt or hand made file
+		// is rejected here instead of reading out of the mapping later
+		auto corners = mesh.indices.count ? mesh.indices.count : mesh.position.count;
+		valid = valid &&
+			corners % 3 == 0 &&
+			(mesh.uv_indices.count == 0 || mesh.uv_indices.count == mesh.indices.count) &&
+			_rexmesh_indices_valid(mesh.indices, mesh.position.count) &&
+			_rexmesh_indices_valid(mesh.uv_indices, mesh.uv.count);
+		if (valid == false)
+		{
+			rc::file_unmap(map);
+			return false;
 		}
+
+		mesh.bb_min = header.bb_min;
+		mesh.bb_max = header.bb_max;
+		mesh.storage = map;
+		self = mesh;
+		return true;
 	}
+
+	Mesh
+	mesh_from_rexmesh(const char* path)
+	{
+		rex_profile_function();
+
+		Mesh self = {};
+		if (_mesh_from_rexmesh(path, nullptr, self) == false)
+			rex_log_error("[rex-raster]: failed to load rexmesh file '%s'", path);
+		return self;
+	}
+
+	bool
+	mesh_save_rexmesh(const Mesh& self, const char* path, const rc::File_Info& source)
+	{
+		rex_profile_function();
+
+		_Rexmesh_Header header = {};
+		header.magic = REXMESH_MAGIC;
+		header.version = REXMESH_VERSION;
+		header.source_size = source.size;
+		header.source_modified_ns = source.modified_ns;
+		header.bb_min = self.bb_min;
+		header.bb_max = self.bb_max;
+
+		uint64_t offset = sizeof(header);
+		_rexmesh_layout(header.arrays[REXMESH_ARRAY_POSITION], self.position, offset);
+		_rexmesh_layout(header.arrays[REXMESH_ARRAY_NORMAL], self.normal, offset);
+		_rexmesh_layout(header.arrays[REXMESH_ARRAY_UV], self.uv, offset);
+		_rexmesh_layout(header.arrays[REXMESH_ARRAY_COLOR], self.color, offset);
+		_rexmesh_layout(header.arrays[REXMESH_ARRAY_INDICES], self.indices, offset);
+		_rexmesh_layout(header.arrays[REXMESH_ARRAY_UV_INDICES], self.uv_indices, offset);
+
+		// written next to the target and renamed over it so readers never map a half written file
+		auto temp_path = rc::str_fmt(rc::frame_allocator(), "%s.tmp", path);
+		auto file = fopen(temp_path.ptr, "wb");
+		if (file == nullptr)
+			return false;
+
+		uint64_t position = sizeof(header);
+		auto written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+			_rexmesh_write(file, header.arrays[REXMESH_ARRAY_POSITION], self.position, position) &&
+			_rexmesh_write(file, header.arrays[REXMESH_ARRAY_NORMAL], self.normal, position) &&
+			_rexmesh_write(file, header.arrays[REXMESH_ARRAY_UV], self.uv, position) &&
+			_rexmesh_write(file, header.arrays[REXMESH_ARRAY_COLOR], self.color, position) &&
+			_rexmesh_write(file, header.arrays[REXMESH_ARRAY_INDICES], self.indices, position) &&
+			_rexmesh_write(file, header.arrays[REXMESH_ARRAY_UV_INDICES], self.uv_indices, position);
+		written = fclose(file) == 0 && written;
+
+		// rename doesn't replace existing files on windows
+#if REX_OS_WINDOWS
+		::remove(path);
 #endif
+		if (written == false || ::rename(temp_path.ptr, path) != 0)
+		{
+			::remove(temp_path.ptr);
+			return false;
+		}
+		return true;
+	}
+
+	Mesh
+	mesh_load(const char* path, rc::Thread_Pool* workers)
+	{
+		rex_profile_function();
+
+		if (rc::file_has_extension(path, ".rexmesh"))
+			return mesh_from_rexmesh(path);
+		// the buffers of a .gltf are other files which the cache key doesn't cover
+		if (rc::file_has_extension(path, ".gltf"))
+			return mesh_from_gltf(path);
+
+		Mesh self = {};
+		auto source = rc::file_info(path);
+		auto cache_path = rc::str_fmt(rc::frame_allocator(), "%s.rexmesh", path);
+		if (source.exists && _mesh_from_rexmesh(cache_path.ptr, &source, self))
+			return self;
+
+		if (rc::file_has_extension(path, ".stl"))
+			self = mesh_from_stl(path);
+		else if (rc::file_has_extension(path, ".glb"))
+			self = mesh_from_gltf(path);
+		else
+			self = mesh_from_obj(path, workers);
+		// a read only data directory only costs the parse on every load
+		if (source.exists && self.position.count && mesh_save_rexmesh(self, cache_path.ptr, source) == false)
+			rex_log_warn("[rex-raster]: failed to write mesh cache '%s'", cache_path.ptr);
+		return self;
+	}
 }
@@ -0,0 +1,336 @@
+#include "rex-raster/raster.h"
+
+#include <rex-core/assert.h>
+#include <rex-core/cpu.h>
+
+#include <rex-math/math.h>
+#include <rex-math/vec2.h>
+#include <rex-math/vec4.h>
+
+#include <float.h>
+
+namespace rex::raster
+{
+	struct Depth_Range
+	{
+		float min, max;
+	};
+
+	// depth of the triangle over the covered pixels of [min, max], widened by the rounding error of
+	// the per pixel interpolation so that the kernels never produce a depth outside of it
+	inline static Depth_Range
+	_depth_range(const Triangle& triangle, math::V2i min, math::V2i max)
+	{
+		auto& z = triangle.z;
+		auto fx0 = (float)(min.x - triangle.bb_min.x), fx1 = (float)(max.x - triangle.bb_min.x);
+		auto fy0 = (float)(min.y - triangle.bb_min.y), fy1 = (float)(max.y - triangle.bb_min.y);
+		auto row0 = z.c + z.dy * fy0, row1 = z.c + z.dy * fy1;
+		float corners[4] = {row0 + z.dx * fx0, row0 + z.dx * fx1, row1 + z.dx * fx0, row1 + z.dx * fx1};
+
+		Depth_Range self = {corners[0], corners[0]};
+		for (auto c: corners)
+		{
+			self.min = math::min(self.min, c);
+			self.max = math::max(self.max, c);
+		}
+
+		// barycentric interpolation never leaves the range of the vertices
+		self.min = math::max(self.min, math::min(math::min(triangle.p0.z, triangle.p1.z), triangle.p2.z));
+		self.max = math::min(self.max, math::max(math::max(triangle.p0.z, triangle.p1.z), triangle.p2.z));
+
+		auto error = (math::abs(z.c) + math::abs(z.dx * fx1) + math::abs(z.dy * fy1)) * 8 * FLT_EPSILON;
+		self.min -= error;
+		self.max += error;
+		return self;
+	}
+
+	inline static float
+	_depth_block_max(const Canvas& canvas, math::V2i min, math::V2i max)
+	{
+		// one running max per column so the compiler can keep them in a simd register
+		float columns[DEPTH_BLOCK_SIZE];
+		for (auto& c: columns)
+			c = -FLT_MAX;
+
+		auto width = max.x - min.x + 1;
+		for (int y = min.y; y <= max.y; ++y)
+		{
+			auto row = canvas.depth.ptr + y * canvas.width + min.x;
+			if (width == DEPTH_BLOCK_SIZE)
+			{
+				for (int x = 0; x < DEPTH_BLOCK_SIZE; ++x)
+					columns[x] = row[x] > columns[x] ? row[x] : columns[x];
+			}
+			else
+			{
+				for (int x = 0; x < width; ++x)
+					columns[x] = row[x] > columns[x] ? row[x] : columns[x];
+			}
+		}
+
+		float self = -FLT_MAX;
+		for (auto c: columns)
+			self = c > self ? c : self;
+		return self;
+	}
+
+	// runs the fragment stage at a pixel and writes the color
+	template <rc::u32 FLAGS>
+	inline static void
+	_pixel_shade(Canvas& canvas, int x, int y, const Texture_Sampling& sampling, const Fragment& fragment)
+	{
+		auto color = shader_fragment<FLAGS>(sampling, fragment);
+		if (canvas.format == CANVAS_FORMAT_PIXEL)
+		{
+			auto pixel = pixel_from_color(color);
+			pixel.a = 255;
+			canvas_pixel(canvas, x, y) = pixel;
+		}
+		else
+		{
+			canvas_color(canvas, x, y) = color;
+		}
+	}
+
+	template <rc::u32 FLAGS>
+	static void
+	_raster_triangle_scalar(Rex* self, const Triangle& triangle, const Rect_Edges& edges)
+	{
+		using S = Shader<FLAGS>;
+
+		auto bb_min = edges.min;
+		auto bb_max = edges.max;
+
+		auto& e = triangle.edges;
+		auto& canvas = self->canvas;
+		auto id = triangle_id(self, triangle);
+		Texture_Sampling sampling = {};
+		if constexpr (S::RASTER_SHADE && S::TEXTURE)
+			sampling = triangle_texture_sampling(self, triangle);
+
+		Fragment fragment = {};
+		fragment.color = math::Color_F32{triangle.r.c, triangle.g.c, triangle.b.c, 1.0f};
+
+		// evaluate the edge functions once at the first pixel then step them incrementally
+		rc::i64 row[3];
+		for (int i = 0; i < 3; ++i)
+			row[i] = e[i].a * bb_min.x + e[i].b * bb_min.y + e[i].c;
+
+		for (int y = bb_min.y; y <= bb_max.y; ++y)
+		{
+			auto fy = (float)(y - triangle.bb_min.y);
+			auto z_row = triangle.z.c + triangle.z.dy * fy;
+			auto u_row = triangle.u.c + triangle.u.dy * fy;
+			auto v_row = triangle.v.c + triangle.v.dy * fy;
+			auto r_row = triangle.r.c + triangle.r.dy * fy;
+			auto g_row = triangle.g.c + triangle.g.dy * fy;
+			auto b_row = triangle.b.c + triangle.b.dy * fy;
+
+			rc::i64 w0 = row[0], w1 = row[1], w2 = row[2];
+			for (int x = bb_min.x; x <= bb_max.x; ++x)
+			{
+				if (((w0 + e[0].bias) | (w1 + e[1].bias) | (w2 + e[2].bias)) >= 0)
+				{
+					auto fx = (float)(x - triangle.bb_min.x);
+					auto z = z_row + triangle.z.dx * fx;
+					if (S::DEPTH_TEST == false || edges.depth_pass || canvas_depth(canvas, x, y) > z)
+					{
+						if constexpr (S::VISIBILITY)
+						{
+							canvas.visibility[y * canvas.width + x] = id;
+						}
+						else
+						{
+							if constexpr (S::TEXTURE)
+							{
+								fragment.u = u_row + triangle.u.dx * fx;
+								fragment.v = 1.0f - (v_row + triangle.v.dx * fx);
+							}
+							if constexpr (S::VARYING_COLOR)
+							{
+								fragment.color.r = r_row + triangle.r.dx * fx;
+								fragment.color.g = g_row + triangle.g.dx * fx;
+								fragment.color.b = b_row + triangle.b.dx * fx;
+							}
+							_pixel_shade<FLAGS>(canvas, x, y, sampling, fragment);
+						}
+						if constexpr (S::DEPTH_TEST)
+							canvas_depth(canvas, x, y) = z;
+					}
+				}
+
+				w0 += e[0].a;
+				w1 += e[1].a;
+				w2 += e[2].a;
+			}
+
+			row[0] += e[0].b;
+			row[1] += e[1].b;
+			row[2] += e[2].b;
+		}
+	}
+
+	const raster_triangle_proc raster_triangle_scalar[SHADER_PERMUTATIONS] = shader_permutations(_raster_triangle_scalar);
+
+	// shades the visible pixels of the tile from the triangles in the visibility buffer, the attribute planes
+	// are evaluated with the same operations as the kernels so every pixel gets the color forward rendering
+	// would have given it
+	template <rc::u32 FLAGS>
+	static void
+	_raster_resolve(Rex* self, math::V2i tile_min, math::V2i tile_max)
+	{
+		using S = Shader<FLAGS>;
+
+		auto& canvas = self->canvas;
+		auto last = VISIBILITY_NONE;
+		const Triangle* triangle = nullptr;
+		Texture_Sampling sampling = {};
+		Fragment fragment = {};
+		for (int y = tile_min.y; y <= tile_max.y; ++y)
+		{
+			auto ids = canvas.visibility.ptr + (rc::sz)y * canvas.width;
+			for (int x = tile_min.x; x <= tile_max.x; ++x)
+			{
+				auto id = ids[x];
+				if (id == VISIBILITY_NONE)
+					continue;
+
+				// neighbouring pixels mostly show the same triangle, so its setup is only redone on a change
+				if (id != last)
+				{
+					last = id;
+					triangle = &self->triangles[id];
+					if constexpr (S::TEXTURE)
+						sampling = triangle_texture_sampling(self, *triangle);
+					fragment.color = math::Color_F32{triangle->r.c, triangle->g.c, triangle->b.c, 1.0f};
+				}
+
+				auto fx = (float)(x - triangle->bb_min.x);
+				auto fy = (float)(y - triangle->bb_min.y);
+				if constexpr (S::TEXTURE)
+				{
+					fragment.u = (triangle->u.c + triangle->u.dy * fy) + triangle->u.dx * fx;
+					fragment.v = 1.0f - ((triangle->v.c + triangle->v.dy * fy) + triangle->v.dx * fx);
+				}
+				if constexpr (S::VARYING_COLOR)
+				{
+					fragment.color.r = (triangle->r.c + triangle->r.dy * fy) + triangle->r.dx * fx;
+					fragment.color.g = (triangle->g.c + triangle->g.dy * fy) + triangle->g.dx * fx;
+					fragment.color.b = (triangle->b.c + triangle->b.dy * fy) + triangle->b.dx * fx;
+				}
+			#if REX_ARCH_X86
+				auto shaded = _shader_fragment<FLAGS>(sampling, fragment.u, fragment.v, _mm_loadu_ps(&fragment.color.r));
+				if (canvas.format == CANVAS_FORMAT_PIXEL)
+					canvas_pixel(canvas, x, y).raw = _pixel_pack(shaded);
+				else
+					_mm_storeu_ps(&canvas_color(canvas, x, y).r, shaded);
+			#else
+				_pixel_shade<FLAGS>(canvas, x, y, sampling, fragment);
+			#endif
+			}
+		}
+	}
+
+	void
+	raster_triangle(Rex* self, raster_triangle_proc kernel, rc::u32 shader, const Triangle& triangle, math::V2i tile_min, math::V2i tile_max, Raster_Stats& stats)
+	{
+		auto& canvas = self->canvas;
+		auto bb_min = math::max(triangle.bb_min, tile_min);
+		auto bb_max = math::min(triangle.bb_max, tile_max);
+		auto depth_test = (shader & SHADER_FLAG_DEPTH_TEST) != 0;
+
+		rc::u64 tested = 0, culled = 0;
+		for (int by = bb_min.y / DEPTH_BLOCK_SIZE; by <= bb_max.y / DEPTH_BLOCK_SIZE; ++by)
+		{
+			for (int bx = bb_min.x / DEPTH_BLOCK_SIZE; bx <= bb_max.x / DEPTH_BLOCK_SIZE; ++bx)
+			{
+				math::V2i block_min = {bx * DEPTH_BLOCK_SIZE, by * DEPTH_BLOCK_SIZE};
+				auto block_max = math::min(block_min + math::V2i{DEPTH_BLOCK_SIZE - 1, DEPTH_BLOCK_SIZE - 1}, tile_max);
+
+				Rect_Edges edges = {};
+				auto coverage = triangle_rect_edges(triangle, block_min, block_max, edges);
+				if (coverage == RECT_COVERAGE_NONE)
+					continue;
+
+				if (depth_test == false)
+				{
+					if (coverage == RECT_COVERAGE_OVERFLOW)
+						raster_triangle_scalar[shader](self, triangle, edges);
+					else
+						kernel(self, triangle, edges);
+					continue;
+				}
+
+				++tested;
+
+				auto block = by * canvas.blocks_x + bx;
+				auto& block_min_depth = canvas.depth_block_min[block];
+				auto& block_max_depth = canvas.depth_block_max[block];
+
+				// nothing in the block is farther than its max, so the whole part is hidden
+				auto range = _depth_range(triangle, edges.min, edges.max);
+				if (range.min < block_max_depth && canvas.depth_block_dirty[block])
+				{
+					// the cached max isn't tight enough to reject the triangle, refresh it from the pixels
+					block_max_depth = _depth_block_max(canvas, block_min, block_max);
+					canvas.depth_block_dirty[block] = false;
+				}
+
+				if (range.min >= block_max_depth)
+				{
+					++culled;
+					continue;
+				}
+
+				edges.depth_pass = range.max < block_min_depth;
+				if (coverage == RECT_COVERAGE_OVERFLOW)
+					raster_triangle_scalar[shader](self, triangle, edges);
+				else
+					kernel(self, triangle, edges);
+
+				// when the whole block is covered every pixel got the triangle depth or kept a closer one,
+				// otherwise the max is refreshed lazily the next time it's needed
+				if (range.min < block_min_depth)
+					block_min_depth = range.min;
+				if (coverage == RECT_COVERAGE_FULL && edges.min == block_min && edges.max == block_max)
+					block_max_depth = math::min(block_max_depth, range.max);
+				else
+					canvas.depth_block_dirty[block] = true;
+			}
+		}
+
+		stats.depth_blocks_tested += tested;
+		stats.depth_blocks_culled += culled;
+		if (tested > 0 && tested == culled)
+			++stats.depth_triangles_culled;
+	}
+
+	raster_triangle_proc
+	raster_triangle_kernel(rc::u32 shader)
+	{
+		rex_assert(shader < SHADER_PERMUTATIONS);
+	#if REX_ARCH_X86
+		static const raster_triangle_proc* kernels = [] {
+			auto features = rc::cpu_features();
+			if (features.avx2)
+				return raster_triangle_avx2;
+			if (features.sse41)
+				return raster_triangle_sse4;
+			return raster_triangle_scalar;
+		}();
+		return kernels[shader];
+	#else
+		return raster_triangle_scalar[shader];
+	#endif
+	}
+
+	void
+	raster_resolve(Rex* self, rc::u32 shader, math::V2i tile_min, math::V2i tile_max)
+	{
+		using raster_resolve_proc = void (*)(Rex* self, math::V2i tile_min, math::V2i tile_max);
+		static const raster_resolve_proc resolve[SHADER_PERMUTATIONS] = shader_permutations(_raster_resolve);
+
+		rex_assert(shader < SHADER_PERMUTATIONS && (shader & SHADER_FLAG_VISIBILITY));
+		resolve[shader](self, tile_min, tile_max);
+	}
+}
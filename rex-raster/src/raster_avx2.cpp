@@ -0,0 +1,341 @@
+#if REX_ARCH_X86
+
+#include "rex-raster/raster.h"
+
+#include <rex-math/math.h>
+#include <rex-math/vec2.h>
+
+#include <immintrin.h>
+
+namespace rex::raster
+{
+	// 8 colors, one per lane
+	struct _Color_Avx2
+	{
+		__m256 r, g, b, a;
+	};
+
+	// the texture functions below are texture.h's on 8 lanes, each one does the same float operations in the
+	// same order as its scalar version so the kernels render bit identical to the scalar ones
+
+	inline static __m256
+	_texture_wrap_avx2(__m256 t, TEXTURE_WRAP wrap)
+	{
+		auto zero = _mm256_setzero_ps();
+		auto one = _mm256_set1_ps(1.0f);
+		auto clamped = _mm256_blendv_ps(one, t, _mm256_cmp_ps(t, one, _CMP_LT_OQ));
+		clamped = _mm256_and_ps(clamped, _mm256_cmp_ps(t, zero, _CMP_GT_OQ));
+		if (wrap == TEXTURE_WRAP_CLAMP)
+			return clamped;
+
+		// out of int range, or nan, there's no fraction left to keep
+		auto in_int = _mm256_and_ps(_mm256_cmp_ps(t, _mm256_set1_ps(-8388608.0f), _CMP_GT_OQ), _mm256_cmp_ps(t, _mm256_set1_ps(8388608.0f), _CMP_LT_OQ));
+		auto i = _mm256_cvtepi32_ps(_mm256_cvttps_epi32(t));
+		auto fraction = _mm256_sub_ps(t, _mm256_blendv_ps(i, _mm256_sub_ps(i, one), _mm256_cmp_ps(i, t, _CMP_GT_OQ)));
+		fraction = _mm256_and_ps(fraction, in_int);
+
+		auto in_unit = _mm256_and_ps(_mm256_cmp_ps(t, zero, _CMP_GE_OQ), _mm256_cmp_ps(t, one, _CMP_LE_OQ));
+		return _mm256_blendv_ps(fraction, clamped, in_unit);
+	}
+
+	// the wrapped coordinates are always inside the level so the gathers need no mask
+	inline static __m256i
+	_texel_gather_avx2(const Texture_Level& level, TEXTURE_LAYOUT layout, __m256i x, __m256i y)
+	{
+		__m256i index;
+		if (layout == TEXTURE_LAYOUT_LINEAR)
+		{
+			index = _mm256_add_epi32(_mm256_mullo_epi32(y, _mm256_set1_epi32(level.width)), x);
+		}
+		else
+		{
+			auto three = _mm256_set1_epi32(3);
+			auto tile = _mm256_add_epi32(_mm256_mullo_epi32(_mm256_srli_epi32(y, 2), _mm256_set1_epi32(level.tiles_x)), _mm256_srli_epi32(x, 2));
+			auto texel = _mm256_add_epi32(_mm256_slli_epi32(_mm256_and_si256(y, three), 2), _mm256_and_si256(x, three));
+			index = _mm256_add_epi32(_mm256_slli_epi32(tile, 4), texel);
+		}
+		return _mm256_i32gather_epi32((const int*)level.texels, index, sizeof(Texel));
+	}
+
+	inline static __m256
+	_texel_channel_avx2(__m256i texels, int shift)
+	{
+		return _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srli_epi32(texels, shift), _mm256_set1_epi32(0xFF)));
+	}
+
+	inline static _Color_Avx2
+	_texture_nearest_avx2(const Texture_Level& level, TEXTURE_LAYOUT layout, __m256 u, __m256 v)
+	{
+		auto x = _mm256_cvttps_epi32(_mm256_mul_ps(u, _mm256_set1_ps((float)level.width)));
+		auto y = _mm256_cvttps_epi32(_mm256_mul_ps(v, _mm256_set1_ps((float)level.height)));
+		x = _mm256_min_epi32(x, _mm256_set1_epi32(level.width - 1));
+		y = _mm256_min_epi32(y, _mm256_set1_epi32(level.height - 1));
+
+		auto texels = _texel_gather_avx2(level, layout, x, y);
+		auto scale = _mm256_set1_ps(255.0f);
+		return _Color_Avx2{
+			_mm256_div_ps(_texel_channel_avx2(texels, 0), scale),
+			_mm256_div_ps(_texel_channel_avx2(texels, 8), scale),
+			_mm256_div_ps(_texel_channel_avx2(texels, 16), scale),
+			_mm256_div_ps(_texel_channel_avx2(texels, 24), scale),
+		};
+	}
+
+	inline static _Color_Avx2
+	_texture_bilinear_avx2(const Texture_Level& level, TEXTURE_WRAP wrap, TEXTURE_LAYOUT layout, __m256 u, __m256 v)
+	{
+		auto one = _mm256_set1_ps(1.0f);
+		auto half = _mm256_set1_ps(0.5f);
+		auto one_i = _mm256_set1_epi32(1);
+		auto x = _mm256_sub_ps(_mm256_mul_ps(u, _mm256_set1_ps((float)level.width)), half);
+		auto y = _mm256_sub_ps(_mm256_mul_ps(v, _mm256_set1_ps((float)level.height)), half);
+		auto x0 = _mm256_sub_epi32(_mm256_cvttps_epi32(_mm256_add_ps(x, one)), one_i);
+		auto y0 = _mm256_sub_epi32(_mm256_cvttps_epi32(_mm256_add_ps(y, one)), one_i);
+		auto fx = _mm256_sub_ps(x, _mm256_cvtepi32_ps(x0));
+		auto fy = _mm256_sub_ps(y, _mm256_cvtepi32_ps(y0));
+		auto x1 = _mm256_add_epi32(x0, one_i);
+		auto y1 = _mm256_add_epi32(y0, one_i);
+
+		auto zero_i = _mm256_setzero_si256();
+		auto width = _mm256_set1_epi32(level.width), height = _mm256_set1_epi32(level.height);
+		auto last_x = _mm256_sub_epi32(width, one_i), last_y = _mm256_sub_epi32(height, one_i);
+		if (wrap == TEXTURE_WRAP_CLAMP)
+		{
+			x0 = _mm256_max_epi32(x0, zero_i);
+			y0 = _mm256_max_epi32(y0, zero_i);
+			x1 = _mm256_min_epi32(x1, last_x);
+			y1 = _mm256_min_epi32(y1, last_y);
+		}
+		else
+		{
+			x0 = _mm256_blendv_epi8(x0, last_x, _mm256_cmpgt_epi32(zero_i, x0));
+			y0 = _mm256_blendv_epi8(y0, last_y, _mm256_cmpgt_epi32(zero_i, y0));
+			x1 = _mm256_and_si256(x1, _mm256_cmpgt_epi32(width, x1));
+			y1 = _mm256_and_si256(y1, _mm256_cmpgt_epi32(height, y1));
+		}
+
+		__m256i texels[4] = {
+			_texel_gather_avx2(level, layout, x0, y0),
+			_texel_gather_avx2(level, layout, x1, y0),
+			_texel_gather_avx2(level, layout, x0, y1),
+			_texel_gather_avx2(level, layout, x1, y1),
+		};
+		auto gx = _mm256_sub_ps(one, fx), gy = _mm256_sub_ps(one, fy);
+		__m256 weights[4] = {_mm256_mul_ps(gx, gy), _mm256_mul_ps(fx, gy), _mm256_mul_ps(gx, fy), _mm256_mul_ps(fx, fy)};
+
+		auto zero = _mm256_setzero_ps();
+		_Color_Avx2 self = {zero, zero, zero, zero};
+		for (int i = 0; i < 4; ++i)
+		{
+			self.r = _mm256_add_ps(self.r, _mm256_mul_ps(_texel_channel_avx2(texels[i], 0), weights[i]));
+			self.g = _mm256_add_ps(self.g, _mm256_mul_ps(_texel_channel_avx2(texels[i], 8), weights[i]));
+			self.b = _mm256_add_ps(self.b, _mm256_mul_ps(_texel_channel_avx2(texels[i], 16), weights[i]));
+			self.a = _mm256_add_ps(self.a, _mm256_mul_ps(_texel_channel_avx2(texels[i], 24), weights[i]));
+		}
+		auto scale = _mm256_set1_ps(255.0f);
+		return _Color_Avx2{_mm256_div_ps(self.r, scale), _mm256_div_ps(self.g, scale), _mm256_div_ps(self.b, scale), _mm256_div_ps(self.a, scale)};
+	}
+
+	inline static _Color_Avx2
+	_texture_sample_avx2(const Texture_Sampling& self, __m256 u, __m256 v)
+	{
+		u = _texture_wrap_avx2(u, self.wrap);
+		v = _texture_wrap_avx2(v, self.wrap);
+
+		switch (self.filter)
+		{
+			case TEXTURE_FILTER_NEAREST:
+				return _texture_nearest_avx2(self.level0, self.layout, u, v);
+			case TEXTURE_FILTER_BILINEAR:
+				return _texture_bilinear_avx2(self.level0, self.wrap, self.layout, u, v);
+			case TEXTURE_FILTER_TRILINEAR:
+			{
+				auto c0 = _texture_bilinear_avx2(self.level0, self.wrap, self.layout, u, v);
+				if (self.blend == 0.0f)
+					return c0;
+				auto c1 = _texture_bilinear_avx2(self.level1, self.wrap, self.layout, u, v);
+				auto t = _mm256_set1_ps(self.blend);
+				return _Color_Avx2{
+					_mm256_add_ps(c0.r, _mm256_mul_ps(_mm256_sub_ps(c1.r, c0.r), t)),
+					_mm256_add_ps(c0.g, _mm256_mul_ps(_mm256_sub_ps(c1.g, c0.g), t)),
+					_mm256_add_ps(c0.b, _mm256_mul_ps(_mm256_sub_ps(c1.b, c0.b), t)),
+					_mm256_add_ps(c0.a, _mm256_mul_ps(_mm256_sub_ps(c1.a, c0.a), t)),
+				};
+			}
+		}
+		return _Color_Avx2{};
+	}
+
+	// truncated and saturated like _pixel_pack
+	inline static __m256i
+	_pixel_channel_avx2(__m256 c)
+	{
+		auto i = _mm256_cvttps_epi32(_mm256_mul_ps(c, _mm256_set1_ps(255.0f)));
+		return _mm256_min_epi32(_mm256_max_epi32(i, _mm256_setzero_si256()), _mm256_set1_epi32(255));
+	}
+
+	inline static __m256i
+	_pixel_pack_avx2(const _Color_Avx2& color)
+	{
+		auto bg = _mm256_or_si256(_pixel_channel_avx2(color.b), _mm256_slli_epi32(_pixel_channel_avx2(color.g), 8));
+		auto ra = _mm256_or_si256(_mm256_slli_epi32(_pixel_channel_avx2(color.r), 16), _mm256_set1_epi32((int)0xFF000000));
+		return _mm256_or_si256(bg, ra);
+	}
+
+	// transposes the lanes into 8 rgba colors and writes the ones of the lanes in mask
+	inline static void
+	_color_store_avx2(float* ptr, __m256 mask, const _Color_Avx2& color)
+	{
+		auto rg_lo = _mm256_unpacklo_ps(color.r, color.g), rg_hi = _mm256_unpackhi_ps(color.r, color.g);
+		auto ba_lo = _mm256_unpacklo_ps(color.b, color.a), ba_hi = _mm256_unpackhi_ps(color.b, color.a);
+		// colors 0 and 4, 1 and 5, 2 and 6, 3 and 7
+		auto c04 = _mm256_shuffle_ps(rg_lo, ba_lo, _MM_SHUFFLE(1, 0, 1, 0));
+		auto c15 = _mm256_shuffle_ps(rg_lo, ba_lo, _MM_SHUFFLE(3, 2, 3, 2));
+		auto c26 = _mm256_shuffle_ps(rg_hi, ba_hi, _MM_SHUFFLE(1, 0, 1, 0));
+		auto c37 = _mm256_shuffle_ps(rg_hi, ba_hi, _MM_SHUFFLE(3, 2, 3, 2));
+
+		__m256 colors[4] = {
+			_mm256_permute2f128_ps(c04, c15, 0x20),
+			_mm256_permute2f128_ps(c26, c37, 0x20),
+			_mm256_permute2f128_ps(c04, c15, 0x31),
+			_mm256_permute2f128_ps(c26, c37, 0x31),
+		};
+		for (int i = 0; i < 4; ++i)
+		{
+			// every lane's mask repeated over the 4 floats of its color
+			auto lanes = _mm256_setr_epi32(i * 2, i * 2, i * 2, i * 2, i * 2 + 1, i * 2 + 1, i * 2 + 1, i * 2 + 1);
+			auto color_mask = _mm256_castps_si256(_mm256_permutevar8x32_ps(mask, lanes));
+			_mm256_maskstore_ps(ptr + i * 8, color_mask, colors[i]);
+		}
+	}
+
+	// spans of 8 pixels starting at multiples of 8, rects start at multiples of DEPTH_BLOCK_SIZE so a
+	// span never crosses into another tile, lanes outside the triangle bounds are masked out and the depth
+	// and visibility buffers are only touched through masked loads and stores
+	template <rc::u32 FLAGS>
+	static void
+	_raster_triangle_avx2(Rex* self, const Triangle& triangle, const Rect_Edges& e)
+	{
+		using S = Shader<FLAGS>;
+
+		auto packed = self->canvas.format == CANVAS_FORMAT_PIXEL;
+		auto pixels = self->canvas.pixels.ptr;
+		auto color = self->canvas.color.ptr;
+		auto depth = self->canvas.depth.ptr;
+		auto visibility = self->canvas.visibility.ptr;
+		auto width = self->canvas.width;
+		auto id = triangle_id(self, triangle);
+		Texture_Sampling sampling = {};
+		if constexpr (S::RASTER_SHADE && S::TEXTURE)
+			sampling = triangle_texture_sampling(self, triangle);
+
+		auto flat = _Color_Avx2{_mm256_set1_ps(triangle.r.c), _mm256_set1_ps(triangle.g.c), _mm256_set1_ps(triangle.b.c), _mm256_set1_ps(1.0f)};
+
+		auto lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		auto x_lo = _mm256_set1_epi32(e.min.x - 1);
+		auto x_hi = _mm256_set1_epi32(e.max.x + 1);
+		auto x_origin = _mm256_set1_epi32(triangle.bb_min.x);
+		auto one = _mm256_set1_ps(1.0f);
+		auto minus_one = _mm256_set1_epi32(-1);
+
+		auto z_dx = _mm256_set1_ps(triangle.z.dx);
+		auto u_dx = _mm256_set1_ps(triangle.u.dx);
+		auto v_dx = _mm256_set1_ps(triangle.v.dx);
+		auto r_dx = _mm256_set1_ps(triangle.r.dx);
+		auto g_dx = _mm256_set1_ps(triangle.g.dx);
+		auto b_dx = _mm256_set1_ps(triangle.b.dx);
+
+		// lanes hold the edge values of x, x + 1, ..., x + 7, wrapping around outside the rect is fine
+		auto x_begin = e.min.x & ~7;
+		__m256i row[3], step_x[3], step_y[3];
+		for (int i = 0; i < 3; ++i)
+		{
+			auto a = _mm256_set1_epi32(e.a[i]);
+			auto c = (rc::i32)((rc::i64)e.c[i] + (rc::i64)e.a[i] * (x_begin - e.min.x));
+			row[i] = _mm256_add_epi32(_mm256_set1_epi32(c), _mm256_mullo_epi32(a, lane));
+			step_x[i] = _mm256_slli_epi32(a, 3);
+			step_y[i] = _mm256_set1_epi32(e.b[i]);
+		}
+
+		for (int y = e.min.y; y <= e.max.y; ++y)
+		{
+			auto fy = (float)(y - triangle.bb_min.y);
+			auto z_row = _mm256_set1_ps(triangle.z.c + triangle.z.dy * fy);
+			auto u_row = _mm256_set1_ps(triangle.u.c + triangle.u.dy * fy);
+			auto v_row = _mm256_set1_ps(triangle.v.c + triangle.v.dy * fy);
+			auto r_row = _mm256_set1_ps(triangle.r.c + triangle.r.dy * fy);
+			auto g_row = _mm256_set1_ps(triangle.g.c + triangle.g.dy * fy);
+			auto b_row = _mm256_set1_ps(triangle.b.c + triangle.b.dy * fy);
+
+			__m256i w[3] = {row[0], row[1], row[2]};
+			for (int x = x_begin; x <= e.max.x; x += 8)
+			{
+				auto xs = _mm256_add_epi32(_mm256_set1_epi32(x), lane);
+				auto inside = _mm256_cmpgt_epi32(_mm256_or_si256(_mm256_or_si256(w[0], w[1]), w[2]), minus_one);
+				inside = _mm256_and_si256(inside, _mm256_cmpgt_epi32(xs, x_lo));
+				inside = _mm256_and_si256(inside, _mm256_cmpgt_epi32(x_hi, xs));
+
+				for (int i = 0; i < 3; ++i)
+					w[i] = _mm256_add_epi32(w[i], step_x[i]);
+
+				if (_mm256_testz_si256(inside, inside))
+					continue;
+
+				auto index = y * width + x;
+				auto fx = _mm256_cvtepi32_ps(_mm256_sub_epi32(xs, x_origin));
+				auto z = _mm256_add_ps(z_row, _mm256_mul_ps(z_dx, fx));
+
+				auto pass = _mm256_castsi256_ps(inside);
+				if constexpr (S::DEPTH_TEST)
+				{
+					if (e.depth_pass == false)
+						pass = _mm256_and_ps(pass, _mm256_cmp_ps(_mm256_maskload_ps(depth + index, inside), z, _CMP_GT_OQ));
+				}
+				auto mask = _mm256_movemask_ps(pass);
+				if (mask == 0)
+					continue;
+
+				if constexpr (S::DEPTH_TEST)
+					_mm256_maskstore_ps(depth + index, _mm256_castps_si256(pass), z);
+
+				if constexpr (S::VISIBILITY)
+				{
+					_mm256_maskstore_epi32((int*)(visibility + index), _mm256_castps_si256(pass), _mm256_set1_epi32((int)id));
+					continue;
+				}
+
+				// the fragment stage and the texture fetch run on the whole span, the colors of the passing lanes
+				// are written with masked stores
+				auto shaded = flat;
+				if constexpr (S::VARYING_COLOR)
+				{
+					shaded.r = _mm256_add_ps(r_row, _mm256_mul_ps(r_dx, fx));
+					shaded.g = _mm256_add_ps(g_row, _mm256_mul_ps(g_dx, fx));
+					shaded.b = _mm256_add_ps(b_row, _mm256_mul_ps(b_dx, fx));
+				}
+				if constexpr (S::TEXTURE)
+				{
+					auto u = _mm256_add_ps(u_row, _mm256_mul_ps(u_dx, fx));
+					auto v = _mm256_add_ps(v_row, _mm256_mul_ps(v_dx, fx));
+					auto texel = _texture_sample_avx2(sampling, u, _mm256_sub_ps(one, v));
+					shaded.r = _mm256_mul_ps(texel.r, shaded.r);
+					shaded.g = _mm256_mul_ps(texel.g, shaded.g);
+					shaded.b = _mm256_mul_ps(texel.b, shaded.b);
+					shaded.a = _mm256_mul_ps(texel.a, shaded.a);
+				}
+
+				if (packed)
+					_mm256_maskstore_epi32((int*)(pixels + index), _mm256_castps_si256(pass), _pixel_pack_avx2(shaded));
+				else
+					_color_store_avx2(&color[index].r, pass, shaded);
+			}
+
+			for (int i = 0; i < 3; ++i)
+				row[i] = _mm256_add_epi32(row[i], step_y[i]);
+		}
+	}
+
+	const raster_triangle_proc raster_triangle_avx2[SHADER_PERMUTATIONS] = shader_permutations(_raster_triangle_avx2);
+}
+
+#endif
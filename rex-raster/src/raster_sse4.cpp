@@ -0,0 +1,364 @@
+#if REX_ARCH_X86
+
+#include "rex-raster/raster.h"
+
+#include <rex-math/math.h>
+#include <rex-math/vec2.h>
+
+#include <smmintrin.h>
+
+#include <string.h>
+
+namespace rex::raster
+{
+	// 4 colors, one per lane
+	struct _Color_Sse4
+	{
+		__m128 r, g, b, a;
+	};
+
+	// the texture functions below are texture.h's on 4 lanes, each one does the same float operations in the
+	// same order as its scalar version so the kernels render bit identical to the scalar ones
+
+	inline static __m128
+	_texture_wrap_sse4(__m128 t, TEXTURE_WRAP wrap)
+	{
+		auto zero = _mm_setzero_ps();
+		auto one = _mm_set1_ps(1.0f);
+		auto clamped = _mm_blendv_ps(one, t, _mm_cmplt_ps(t, one));
+		clamped = _mm_and_ps(clamped, _mm_cmpgt_ps(t, zero));
+		if (wrap == TEXTURE_WRAP_CLAMP)
+			return clamped;
+
+		// out of int range, or nan, there's no fraction left to keep
+		auto in_int = _mm_and_ps(_mm_cmpgt_ps(t, _mm_set1_ps(-8388608.0f)), _mm_cmplt_ps(t, _mm_set1_ps(8388608.0f)));
+		auto i = _mm_cvtepi32_ps(_mm_cvttps_epi32(t));
+		auto fraction = _mm_sub_ps(t, _mm_blendv_ps(i, _mm_sub_ps(i, one), _mm_cmpgt_ps(i, t)));
+		fraction = _mm_and_ps(fraction, in_int);
+
+		auto in_unit = _mm_and_ps(_mm_cmpge_ps(t, zero), _mm_cmple_ps(t, one));
+		return _mm_blendv_ps(fraction, clamped, in_unit);
+	}
+
+	// the addresses are computed on all lanes, sse has no gather so the texels are loaded one by one. the
+	// wrapped coordinates are always inside the level
+	inline static __m128i
+	_texel_gather_sse4(const Texture_Level& level, TEXTURE_LAYOUT layout, __m128i x, __m128i y)
+	{
+		__m128i index;
+		if (layout == TEXTURE_LAYOUT_LINEAR)
+		{
+			index = _mm_add_epi32(_mm_mullo_epi32(y, _mm_set1_epi32(level.width)), x);
+		}
+		else
+		{
+			auto three = _mm_set1_epi32(3);
+			auto tile = _mm_add_epi32(_mm_mullo_epi32(_mm_srli_epi32(y, 2), _mm_set1_epi32(level.tiles_x)), _mm_srli_epi32(x, 2));
+			auto texel = _mm_add_epi32(_mm_slli_epi32(_mm_and_si128(y, three), 2), _mm_and_si128(x, three));
+			index = _mm_add_epi32(_mm_slli_epi32(tile, 4), texel);
+		}
+
+		alignas(16) rc::i32 indices[4];
+		alignas(16) rc::u32 texels[4];
+		_mm_store_si128((__m128i*)indices, index);
+		for (int k = 0; k < 4; ++k)
+			::memcpy(&texels[k], &level.texels[indices[k]], sizeof(Texel));
+		return _mm_load_si128((const __m128i*)texels);
+	}
+
+	inline static __m128
+	_texel_channel_sse4(__m128i texels, int shift)
+	{
+		return _mm_cvtepi32_ps(_mm_and_si128(_mm_srli_epi32(texels, shift), _mm_set1_epi32(0xFF)));
+	}
+
+	inline static _Color_Sse4
+	_texture_nearest_sse4(const Texture_Level& level, TEXTURE_LAYOUT layout, __m128 u, __m128 v)
+	{
+		auto x = _mm_cvttps_epi32(_mm_mul_ps(u, _mm_set1_ps((float)level.width)));
+		auto y = _mm_cvttps_epi32(_mm_mul_ps(v, _mm_set1_ps((float)level.height)));
+		x = _mm_min_epi32(x, _mm_set1_epi32(level.width - 1));
+		y = _mm_min_epi32(y, _mm_set1_epi32(level.height - 1));
+
+		auto texels = _texel_gather_sse4(level, layout, x, y);
+		auto scale = _mm_set1_ps(255.0f);
+		return _Color_Sse4{
+			_mm_div_ps(_texel_channel_sse4(texels, 0), scale),
+			_mm_div_ps(_texel_channel_sse4(texels, 8), scale),
+			_mm_div_ps(_texel_channel_sse4(texels, 16), scale),
+			_mm_div_ps(_texel_channel_sse4(texels, 24), scale),
+		};
+	}
+
+	inline static _Color_Sse4
+	_texture_bilinear_sse4(const Texture_Level& level, TEXTURE_WRAP wrap, TEXTURE_LAYOUT layout, __m128 u, __m128 v)
+	{
+		auto one = _mm_set1_ps(1.0f);
+		auto half = _mm_set1_ps(0.5f);
+		auto one_i = _mm_set1_epi32(1);
+		auto x = _mm_sub_ps(_mm_mul_ps(u, _mm_set1_ps((float)level.width)), half);
+		auto y = _mm_sub_ps(_mm_mul_ps(v, _mm_set1_ps((float)level.height)), half);
+		auto x0 = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(x, one)), one_i);
+		auto y0 = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(y, one)), one_i);
+		auto fx = _mm_sub_ps(x, _mm_cvtepi32_ps(x0));
+		auto fy = _mm_sub_ps(y, _mm_cvtepi32_ps(y0));
+		auto x1 = _mm_add_epi32(x0, one_i);
+		auto y1 = _mm_add_epi32(y0, one_i);
+
+		auto zero_i = _mm_setzero_si128();
+		auto width = _mm_set1_epi32(level.width), height = _mm_set1_epi32(level.height);
+		auto last_x = _mm_sub_epi32(width, one_i), last_y = _mm_sub_epi32(height, one_i);
+		if (wrap == TEXTURE_WRAP_CLAMP)
+		{
+			x0 = _mm_max_epi32(x0, zero_i);
+			y0 = _mm_max_epi32(y0, zero_i);
+			x1 = _mm_min_epi32(x1, last_x);
+			y1 = _mm_min_epi32(y1, last_y);
+		}
+		else
+		{
+			x0 = _mm_blendv_epi8(x0, last_x, _mm_cmpgt_epi32(zero_i, x0));
+			y0 = _mm_blendv_epi8(y0, last_y, _mm_cmpgt_epi32(zero_i, y0));
+			x1 = _mm_and_si128(x1, _mm_cmpgt_epi32(width, x1));
+			y1 = _mm_and_si128(y1, _mm_cmpgt_epi32(height, y1));
+		}
+
+		__m128i texels[4] = {
+			_texel_gather_sse4(level, layout, x0, y0),
+			_texel_gather_sse4(level, layout, x1, y0),
+			_texel_gather_sse4(level, layout, x0, y1),
+			_texel_gather_sse4(level, layout, x1, y1),
+		};
+		auto gx = _mm_sub_ps(one, fx), gy = _mm_sub_ps(one, fy);
+		__m128 weights[4] = {_mm_mul_ps(gx, gy), _mm_mul_ps(fx, gy), _mm_mul_ps(gx, fy), _mm_mul_ps(fx, fy)};
+
+		auto zero = _mm_setzero_ps();
+		_Color_Sse4 self = {zero, zero, zero, zero};
+		for (int i = 0; i < 4; ++i)
+		{
+			self.r = _mm_add_ps(self.r, _mm_mul_ps(_texel_channel_sse4(texels[i], 0), weights[i]));
+			self.g = _mm_add_ps(self.g, _mm_mul_ps(_texel_channel_sse4(texels[i], 8), weights[i]));
+			self.b = _mm_add_ps(self.b, _mm_mul_ps(_texel_channel_sse4(texels[i], 16), weights[i]));
+			self.a = _mm_add_ps(self.a, _mm_mul_ps(_texel_channel_sse4(texels[i], 24), weights[i]));
+		}
+		auto scale = _mm_set1_ps(255.0f);
+		return _Color_Sse4{_mm_div_ps(self.r, scale), _mm_div_ps(self.g, scale), _mm_div_ps(self.b, scale), _mm_div_ps(self.a, scale)};
+	}
+
+	inline static _Color_Sse4
+	_texture_sample_sse4(const Texture_Sampling& self, __m128 u, __m128 v)
+	{
+		u = _texture_wrap_sse4(u, self.wrap);
+		v = _texture_wrap_sse4(v, self.wrap);
+
+		switch (self.filter)
+		{
+			case TEXTURE_FILTER_NEAREST:
+				return _texture_nearest_sse4(self.level0, self.layout, u, v);
+			case TEXTURE_FILTER_BILINEAR:
+				return _texture_bilinear_sse4(self.level0, self.wrap, self.layout, u, v);
+			case TEXTURE_FILTER_TRILINEAR:
+			{
+				auto c0 = _texture_bilinear_sse4(self.level0, self.wrap, self.layout, u, v);
+				if (self.blend == 0.0f)
+					return c0;
+				auto c1 = _texture_bilinear_sse4(self.level1, self.wrap, self.layout, u, v);
+				auto t = _mm_set1_ps(self.blend);
+				return _Color_Sse4{
+					_mm_add_ps(c0.r, _mm_mul_ps(_mm_sub_ps(c1.r, c0.r), t)),
+					_mm_add_ps(c0.g, _mm_mul_ps(_mm_sub_ps(c1.g, c0.g), t)),
+					_mm_add_ps(c0.b, _mm_mul_ps(_mm_sub_ps(c1.b, c0.b), t)),
+					_mm_add_ps(c0.a, _mm_mul_ps(_mm_sub_ps(c1.a, c0.a), t)),
+				};
+			}
+		}
+		return _Color_Sse4{};
+	}
+
+	// truncated and saturated like _pixel_pack
+	inline static __m128i
+	_pixel_channel_sse4(__m128 c)
+	{
+		auto i = _mm_cvttps_epi32(_mm_mul_ps(c, _mm_set1_ps(255.0f)));
+		return _mm_min_epi32(_mm_max_epi32(i, _mm_setzero_si128()), _mm_set1_epi32(255));
+	}
+
+	inline static __m128i
+	_pixel_pack_sse4(const _Color_Sse4& color)
+	{
+		auto bg = _mm_or_si128(_pixel_channel_sse4(color.b), _mm_slli_epi32(_pixel_channel_sse4(color.g), 8));
+		auto ra = _mm_or_si128(_mm_slli_epi32(_pixel_channel_sse4(color.r), 16), _mm_set1_epi32((int)0xFF000000));
+		return _mm_or_si128(bg, ra);
+	}
+
+	// spans of 4 pixels starting at multiples of 4, rects start at multiples of DEPTH_BLOCK_SIZE so a
+	// span never crosses into another tile, sse has no masked loads so spans hanging over the right
+	// edge of the canvas fall back to per lane depth access
+	template <rc::u32 FLAGS>
+	static void
+	_raster_triangle_sse4(Rex* self, const Triangle& triangle, const Rect_Edges& e)
+	{
+		using S = Shader<FLAGS>;
+
+		auto packed = self->canvas.format == CANVAS_FORMAT_PIXEL;
+		auto pixels = self->canvas.pixels.ptr;
+		auto color = self->canvas.color.ptr;
+		auto depth = self->canvas.depth.ptr;
+		auto visibility = self->canvas.visibility.ptr;
+		auto width = self->canvas.width;
+		auto id = triangle_id(self, triangle);
+		Texture_Sampling sampling = {};
+		if constexpr (S::RASTER_SHADE && S::TEXTURE)
+			sampling = triangle_texture_sampling(self, triangle);
+
+		auto flat = _Color_Sse4{_mm_set1_ps(triangle.r.c), _mm_set1_ps(triangle.g.c), _mm_set1_ps(triangle.b.c), _mm_set1_ps(1.0f)};
+		auto lane_bits = _mm_setr_epi32(1, 2, 4, 8);
+
+		auto lane = _mm_setr_epi32(0, 1, 2, 3);
+		auto x_lo = _mm_set1_epi32(e.min.x - 1);
+		auto x_hi = _mm_set1_epi32(e.max.x + 1);
+		auto x_origin = _mm_set1_epi32(triangle.bb_min.x);
+		auto one = _mm_set1_ps(1.0f);
+		auto minus_one = _mm_set1_epi32(-1);
+
+		auto z_dx = _mm_set1_ps(triangle.z.dx);
+		auto u_dx = _mm_set1_ps(triangle.u.dx);
+		auto v_dx = _mm_set1_ps(triangle.v.dx);
+		auto r_dx = _mm_set1_ps(triangle.r.dx);
+		auto g_dx = _mm_set1_ps(triangle.g.dx);
+		auto b_dx = _mm_set1_ps(triangle.b.dx);
+
+		// lanes hold the edge values of x, x + 1, x + 2, x + 3, wrapping around outside the rect is fine
+		auto x_begin = e.min.x & ~3;
+		__m128i row[3], step_x[3], step_y[3];
+		for (int i = 0; i < 3; ++i)
+		{
+			auto a = _mm_set1_epi32(e.a[i]);
+			auto c = (rc::i32)((rc::i64)e.c[i] + (rc::i64)e.a[i] * (x_begin - e.min.x));
+			row[i] = _mm_add_epi32(_mm_set1_epi32(c), _mm_mullo_epi32(a, lane));
+			step_x[i] = _mm_slli_epi32(a, 2);
+			step_y[i] = _mm_set1_epi32(e.b[i]);
+		}
+
+		alignas(16) float z_lanes[4];
+		for (int y = e.min.y; y <= e.max.y; ++y)
+		{
+			auto fy = (float)(y - triangle.bb_min.y);
+			auto z_row = _mm_set1_ps(triangle.z.c + triangle.z.dy * fy);
+			auto u_row = _mm_set1_ps(triangle.u.c + triangle.u.dy * fy);
+			auto v_row = _mm_set1_ps(triangle.v.c + triangle.v.dy * fy);
+			auto r_row = _mm_set1_ps(triangle.r.c + triangle.r.dy * fy);
+			auto g_row = _mm_set1_ps(triangle.g.c + triangle.g.dy * fy);
+			auto b_row = _mm_set1_ps(triangle.b.c + triangle.b.dy * fy);
+
+			__m128i w[3] = {row[0], row[1], row[2]};
+			for (int x = x_begin; x <= e.max.x; x += 4)
+			{
+				auto xs = _mm_add_epi32(_mm_set1_epi32(x), lane);
+				auto inside = _mm_cmpgt_epi32(_mm_or_si128(_mm_or_si128(w[0], w[1]), w[2]), minus_one);
+				inside = _mm_and_si128(inside, _mm_cmpgt_epi32(xs, x_lo));
+				inside = _mm_and_si128(inside, _mm_cmpgt_epi32(x_hi, xs));
+
+				for (int i = 0; i < 3; ++i)
+					w[i] = _mm_add_epi32(w[i], step_x[i]);
+
+				auto covered = _mm_movemask_ps(_mm_castsi128_ps(inside));
+				if (covered == 0)
+					continue;
+
+				auto index = y * width + x;
+				auto fx = _mm_cvtepi32_ps(_mm_sub_epi32(xs, x_origin));
+				auto z = _mm_add_ps(z_row, _mm_mul_ps(z_dx, fx));
+
+				int mask = covered;
+				if constexpr (S::DEPTH_TEST)
+				{
+					if (x + 3 <= e.rect_max.x)
+					{
+						auto old = _mm_loadu_ps(depth + index);
+						auto pass = _mm_castsi128_ps(inside);
+						if (e.depth_pass == false)
+							pass = _mm_and_ps(pass, _mm_cmpgt_ps(old, z));
+						mask = _mm_movemask_ps(pass);
+						_mm_storeu_ps(depth + index, _mm_blendv_ps(old, z, pass));
+					}
+					else
+					{
+						mask = 0;
+						_mm_store_ps(z_lanes, z);
+						for (int k = 0; k < 4; ++k)
+						{
+							if ((covered & (1 << k)) && (e.depth_pass || depth[index + k] > z_lanes[k]))
+							{
+								depth[index + k] = z_lanes[k];
+								mask |= 1 << k;
+							}
+						}
+					}
+
+					if (mask == 0)
+						continue;
+				}
+
+				if constexpr (S::VISIBILITY)
+				{
+					for (int k = 0; k < 4; ++k)
+						if (mask & (1 << k))
+							visibility[index + k] = id;
+					continue;
+				}
+
+				// the fragment stage and the texture fetch run on the whole span
+				auto shaded = flat;
+				if constexpr (S::VARYING_COLOR)
+				{
+					shaded.r = _mm_add_ps(r_row, _mm_mul_ps(r_dx, fx));
+					shaded.g = _mm_add_ps(g_row, _mm_mul_ps(g_dx, fx));
+					shaded.b = _mm_add_ps(b_row, _mm_mul_ps(b_dx, fx));
+				}
+				if constexpr (S::TEXTURE)
+				{
+					auto u = _mm_add_ps(u_row, _mm_mul_ps(u_dx, fx));
+					auto v = _mm_add_ps(v_row, _mm_mul_ps(v_dx, fx));
+					auto texel = _texture_sample_sse4(sampling, u, _mm_sub_ps(one, v));
+					shaded.r = _mm_mul_ps(texel.r, shaded.r);
+					shaded.g = _mm_mul_ps(texel.g, shaded.g);
+					shaded.b = _mm_mul_ps(texel.b, shaded.b);
+					shaded.a = _mm_mul_ps(texel.a, shaded.a);
+				}
+
+				// spans inside the rect blend the passing lanes into the pixels, like the depth above
+				if (packed && x + 3 <= e.rect_max.x)
+				{
+					auto pass = _mm_cmpeq_epi32(_mm_and_si128(_mm_set1_epi32(mask), lane_bits), lane_bits);
+					auto old = _mm_loadu_si128((const __m128i*)(pixels + index));
+					_mm_storeu_si128((__m128i*)(pixels + index), _mm_blendv_epi8(old, _pixel_pack_sse4(shaded), pass));
+				}
+				else if (packed)
+				{
+					alignas(16) rc::u32 packed_lanes[4];
+					_mm_store_si128((__m128i*)packed_lanes, _pixel_pack_sse4(shaded));
+					for (int k = 0; k < 4; ++k)
+						if (mask & (1 << k))
+							pixels[index + k].raw = packed_lanes[k];
+				}
+				else
+				{
+					// each color is one store once the lanes are transposed
+					_MM_TRANSPOSE4_PS(shaded.r, shaded.g, shaded.b, shaded.a);
+					__m128 colors[4] = {shaded.r, shaded.g, shaded.b, shaded.a};
+					for (int k = 0; k < 4; ++k)
+						if (mask & (1 << k))
+							_mm_storeu_ps(&color[index + k].r, colors[k]);
+				}
+			}
+
+			for (int i = 0; i < 3; ++i)
+				row[i] = _mm_add_epi32(row[i], step_y[i]);
+		}
+	}
+
+	const raster_triangle_proc raster_triangle_sse4[SHADER_PERMUTATIONS] = shader_permutations(_raster_triangle_sse4);
+}
+
+#endif
@@ -1,10 +1,15 @@
 #include "rex-raster/exports.h"
 #include "rex-raster/rex.h"
+#include "rex-raster/raster.h"
 #include "rex-raster/stb_image.h"
 
 #include <rex-core/str.h>
 #include <rex-core/defer.h>
+#include <rex-core/log.h>
 #include <rex-core/path.h>
+#include <rex-core/pixels.h>
+#include <rex-core/profile.h>
+#include <rex-core/time.h>
 
 #include <rex-math/math.h>
 #include <rex-math/vec2.h>
@@ -13,6 +18,7 @@
 #include <rex-math/mat4.h>
 
 #include <float.h>
+#include <string.h>
 
 namespace rex::raster
 {
@@ -34,8 +40,9 @@ namespace rex::raster
 	}
 
 	// source: https://github.com/ssloy/tinyrenderer/wiki/Lesson-1:-Bresenham%E2%80%99s-Line-Drawing-Algorithm#timings-fifth-and-final-attempt
+	// only writes the pixels inside the inclusive rect [rect_min, rect_max]
 	inline static void
-	_raster_line(Rex* self, math::V2i p0, math::V2i p1, math::Color_F32 color)
+	_raster_line(Rex* self, math::V2i p0, math::V2i p1, math::Color_F32 color, math::V2i rect_min, math::V2i rect_max)
 	{
 		bool steep = false;
 		if (math::abs(p0.x - p1.x) < math::abs(p0.y - p1.y))
@@ -54,10 +61,9 @@ namespace rex::raster
 		int y = p0.y;
 		for (int x = p0.x; x <= p1.x; x++)
 		{
-			if (steep)
-				canvas_color(self->canvas, y, x) = color;
-			else
-				canvas_color(self->canvas, x, y) = color;
+			auto pixel = steep ? math::V2i{y, x} : math::V2i{x, y};
+			if (pixel.x >= rect_min.x && pixel.x <= rect_max.x && pixel.y >= rect_min.y && pixel.y <= rect_max.y)
+				canvas_write(self->canvas, pixel.x, pixel.y, color);
 
 			error2 += derror2;
 			if (error2 > d.x)
@@ -68,105 +74,311 @@ namespace rex::raster
 		}
 	}
 
-	inline static math::V3
-	_barycentric(math::V2 p0, math::V2 p1, math::V2 p2, math::V2 p)
+	// the edges of the triangle inside the inclusive pixel rect [rect_min, rect_max], without depth
+	inline static void
+	_raster_wireframe(Rex* self, const Triangle& triangle, math::V2i rect_min, math::V2i rect_max)
+	{
+		math::V2i p[3] = {
+			{(int)triangle.p0.x, (int)triangle.p0.y},
+			{(int)triangle.p1.x, (int)triangle.p1.y},
+			{(int)triangle.p2.x, (int)triangle.p2.y},
+		};
+		for (int i = 0; i < 3; ++i)
+			_raster_line(self, p[i], p[(i + 1) % 3], {1.0f, 1.0f, 1.0f, 1.0f}, rect_min, rect_max);
+	}
+
+	// clear, rasterize and blit a single tile, each tile is owned by exactly one worker so there is
+	// no need to synchronize access to the canvas or the screen
+	static void
+	_raster_tile(void* user_data, rc::u32 index, rc::u32 worker)
+	{
+		rex_profile_zone("tile");
+
+		auto self = (Rex*)user_data;
+		auto& canvas = self->canvas;
+		auto& bin = self->tiles.bins[index];
+		auto& stats = self->worker_stats[worker];
+
+		math::V2i tile_min = {
+			(int)(index % self->tiles.count_x) * TILE_SIZE,
+			(int)(index / self->tiles.count_x) * TILE_SIZE
+		};
+		math::V2i tile_max = {
+			math::min(tile_min.x + TILE_SIZE, canvas.width) - 1,
+			math::min(tile_min.y + TILE_SIZE, canvas.height) - 1
+		};
+
+		canvas_clear(canvas, {0.1f, 0.1f, 0.1f, 1.0f}, 1.0f, tile_min, tile_max);
+
+		if (self->wireframe)
+		{
+			for (auto triangle_index: bin)
+				_raster_wireframe(self, self->triangles[triangle_index], tile_min, tile_max);
+		}
+		else
+		{
+			auto visibility = (self->shader & SHADER_FLAG_VISIBILITY) != 0;
+			if (visibility)
+				canvas_visibility_clear(canvas, tile_min, tile_max);
+
+			auto kernel = raster_triangle_kernel(self->shader);
+			for (auto triangle_index: bin)
+				raster_triangle(self, kernel, self->shader, self->triangles[triangle_index], tile_min, tile_max, stats);
+
+			// the visible triangles are only known once the whole bin is in, shade them while the tile is hot
+			if (visibility)
+				raster_resolve(self, self->shader, tile_min, tile_max);
+		}
+
+		// blit to screen, a pixel canvas is already in the screen format so it is a copy per row
+		rex_profile_zone("blit");
+		auto blit_start = rc::time_nanoseconds();
+		auto tile_width = (rc::sz)(tile_max.x - tile_min.x + 1);
+		for (int y = tile_min.y; y <= tile_max.y; ++y)
+		{
+			auto offset = (rc::sz)y * canvas.width + tile_min.x;
+			auto screen = self->screen + (rc::sz)y * self->screen_width + tile_min.x;
+			if (canvas.format == CANVAS_FORMAT_PIXEL)
+			{
+				::memcpy(screen, canvas.pixels.ptr + offset, tile_width * sizeof(Rex_Pixel));
+			}
+			else
+			{
+				// float rgba to 8-bit in place on the screen row, then to the window byte order and opaque
+				rc::pixels_f32_to_u8(&canvas.color.ptr[offset].r, (rc::u8*)screen, tile_width * 4);
+			#if !REX_OS_WASM
+				rc::pixels_swizzle_rb(&screen->raw, &screen->raw, tile_width);
+			#endif
+				for (rc::sz x = 0; x < tile_width; ++x)
+					screen[x].raw |= 0xFF000000;
+			}
+		}
+		stats.blit_ns += rc::time_nanoseconds() - blit_start;
+	}
+
+	// lights, sets up and bins a screen space triangle, gouraud colors come in already lit
+	template <rc::u32 FLAGS>
+	inline static void
+	_triangle_submit(Rex* self, const Vertex_Shader<FLAGS>& vertex_shader, math::V3 p0, math::V3 p1, math::V3 p2, math::V2 uv0, math::V2 uv1, math::V2 uv2, const math::Color_F32 (&colors)[3])
 	{
-		auto u = math::cross(
-			math::V3{p2.x - p0.x, p1.x - p0.x, p0.x - p.x},
-			math::V3{p2.y - p0.y, p1.y - p0.y, p0.y - p.y}
-		);
+		using S = Shader<FLAGS>;
+		auto& stats = self->stats;
 
-		if (math::abs(u.z) <= 1e-2)
-			return {-1.0f, 1.0f, 1.0f};
+		math::Color_F32 lit[3] = {colors[0], colors[1], colors[2]};
+		if constexpr (S::GOURAUD == false)
+		{
+			// flat shading lights the face once with its screen space normal
+			auto normal = -math::cross(p2 - p0, p1 - p0);
+			if constexpr (S::VERTEX_COLOR)
+			{
+				for (int i = 0; i < 3; ++i)
+					lit[i] = vertex_shader(normal, colors[i]);
+			}
+			else
+			{
+				lit[0] = vertex_shader(normal, colors[0]);
+				lit[1] = lit[0];
+				lit[2] = lit[0];
+			}
+		}
 
-		return {1.0f - (u.x + u.y) / u.z, u.y / u.z, u.x / u.z};
+		Triangle triangle = {};
+		triangle.p0 = p0;
+		triangle.p1 = p1;
+		triangle.p2 = p2;
+		triangle.uv0 = uv0;
+		triangle.uv1 = uv1;
+		triangle.uv2 = uv2;
+
+		switch (triangle_setup(triangle, self->canvas.width, self->canvas.height, self->cull_backfaces, lit))
+		{
+			case TRIANGLE_CULL_NONE:
+				++stats.triangles_rasterized;
+				tiles_bin(self->tiles, triangle, (rc::u32)self->triangles.count);
+				rc::vec_push(self->triangles, triangle);
+				break;
+			case TRIANGLE_CULL_FRUSTUM:
+				++stats.triangles_culled_frustum;
+				break;
+			case TRIANGLE_CULL_BACKFACE:
+				++stats.triangles_culled_backface;
+				break;
+			case TRIANGLE_CULL_DEGENERATE:
+				++stats.triangles_culled_degenerate;
+				break;
+			case TRIANGLE_CULL_EMPTY:
+				++stats.triangles_culled_empty;
+				break;
+		}
 	}
 
+	// vertex indices of the triangle starting at index i of the mesh
 	inline static void
-	_raster_triangle(Rex* self, math::V3 p0, math::V3 p1, math::V3 p2, math::V2 uv0, math::V2 uv1, math::V2 uv2, float intensity)
+	_triangle_indices(const Mesh& mesh, rc::sz i, rc::sz (&indices)[3])
 	{
-	#define _LINE_SWEEPING 0
-	#if _LINE_SWEEPING
-		// skip degenerate triangles
-		if (p0.y == p1.y && p0.y == p2.y) return;
+		for (int k = 0; k < 3; ++k)
+			indices[k] = mesh.indices.count ? mesh.indices[i + k] : i + k;
+	}
 
-		// sort the vertices, p0, p1, p2 lower−to−upper
-		if (p0.y > p1.y) _swap(p0, p1);
-		if (p0.y > p2.y) _swap(p0, p2);
-		if (p1.y > p2.y) _swap(p1, p2);
+	// gouraud lights each vertex with the sum of the screen space normals of its faces, their lengths weight
+	// them by area. faces crossing the near plane have no meaningful screen positions and are left out
+	inline static void
+	_vertex_normals_update(Rex* self)
+	{
+		auto& mesh = self->mesh;
+		auto& vertices = self->vertices;
+		auto& normals = self->vertex_normals;
+		rc::vec_resize(normals, mesh.position.count);
+		rc::vec_fill(normals, math::V3{});
 
-		for (float y = p0.y; y <= p2.y; ++y)
+		auto count = (mesh.indices.count ? mesh.indices.count : mesh.position.count);
+		for (rc::sz i = 0; i < count; i += 3)
 		{
-			// top half or bottom half
-			auto bottom_half = y > p1.y || p0.y == p1.y;
-			auto _p0 = bottom_half ? p1 : p0;
-			auto _p1 = bottom_half ? p2 : p1;
-
-			// short line
-			auto t0 = (float)(y - _p0.y) / (_p1.y - _p0.y);
-			auto a = _p0 + (_p1 - _p0) * t0;
-
-			// long line
-			auto t1 = (float)(y - p0.y) / (p2.y - p0.y);
-			auto b = p0 + (p2 - p0) * t1;
-
-			if (a.x > b.x) _swap(a, b);
-			for (float x = a.x; x <= b.x; ++x)
-				canvas_color(self->canvas, (int)x, (int)y) = color;
+			rc::sz indices[3];
+			_triangle_indices(mesh, i, indices);
+			if ((vertices.outcode[indices[0]] | vertices.outcode[indices[1]] | vertices.outcode[indices[2]]) & CLIP_PLANE_NEAR)
+				continue;
+
+			auto p0 = vertices_screen(vertices, indices[0]);
+			auto p1 = vertices_screen(vertices, indices[1]);
+			auto p2 = vertices_screen(vertices, indices[2]);
+			auto normal = -math::cross(p2 - p0, p1 - p0);
+			for (auto index: indices)
+				normals[index] += normal;
 		}
-	#else
-		auto bb_min = math::max(math::min(math::min(p0.xy, p1.xy), p2.xy), math::V2{0, 0});
-		auto bb_max = math::min(math::max(math::max(p0.xy, p1.xy), p2.xy), math::V2{(float)self->canvas.width - 1, (float)self->canvas.height - 1});
+	}
+
+	// runs the vertex stage of the shader on every triangle then clips, sets up and bins them
+	template <rc::u32 FLAGS>
+	static void
+	_triangles_submit(Rex* self, math::V2 viewport_size)
+	{
+		using S = Shader<FLAGS>;
+
+		auto& mesh = self->mesh;
+		auto& vertices = self->vertices;
+		auto& stats = self->stats;
+		auto vertex_shader = Vertex_Shader<FLAGS>{math::V3{0.0f, 0.0f, -1.0f}};
 
-		// round
-		bb_min = {(float)(int)bb_min.x, (float)(int)bb_min.y};
-		bb_max = {(float)(int)bb_max.x, (float)(int)bb_max.y};
+		// meshes without uvs sample the middle of the texture
+		auto has_uv = mesh.uv_indices.count > 0;
+		// vertex colors follow the positions, meshes without them are white
+		auto has_color = mesh.color.count > 0 && mesh.color.count == mesh.position.count;
 
-		math::V2 p = {};
-		for (p.y = bb_min.y; p.y <= bb_max.y; ++p.y)
+		if constexpr (S::GOURAUD)
+			_vertex_normals_update(self);
+
+		auto count = (mesh.indices.count ? mesh.indices.count : mesh.position.count);
+		for (rc::sz i = 0; i < count; i += 3)
 		{
-			for (p.x = bb_min.x; p.x <= bb_max.x; ++p.x)
+			rc::sz indices[3];
+			_triangle_indices(mesh, i, indices);
+			auto i0 = indices[0], i1 = indices[1], i2 = indices[2];
+
+			auto out0 = vertices.outcode[i0];
+			auto out1 = vertices.outcode[i1];
+			auto out2 = vertices.outcode[i2];
+
+			++stats.triangles_submitted;
+
+			if (out0 & out1 & out2 & CLIP_PLANE_VIEW)
 			{
-				auto w = _barycentric(p0.xy, p1.xy, p2.xy, p);
-				if (w.x < 0 || w.y < 0 || w.z < 0)
+				++stats.triangles_culled_frustum;
+				continue;
+			}
+
+			auto uv0 = has_uv ? mesh.uv[mesh.uv_indices[i+0]] : math::V2{0.5f, 0.5f};
+			auto uv1 = has_uv ? mesh.uv[mesh.uv_indices[i+1]] : math::V2{0.5f, 0.5f};
+			auto uv2 = has_uv ? mesh.uv[mesh.uv_indices[i+2]] : math::V2{0.5f, 0.5f};
+
+			math::Color_F32 colors[3] = {{1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}};
+			if constexpr (S::VERTEX_COLOR)
+			{
+				if (has_color)
+					for (int k = 0; k < 3; ++k)
+						colors[k] = mesh.color[indices[k]];
+			}
+			if constexpr (S::GOURAUD)
+			{
+				for (int k = 0; k < 3; ++k)
+					colors[k] = vertex_shader(self->vertex_normals[indices[k]], colors[k]);
+			}
+
+			// clip in homogeneous space so vertices behind the camera never reach the divide
+			if (auto planes = (out0 | out1 | out2) & CLIP_PLANE_CLIP)
+			{
+				++stats.triangles_clipped;
+
+				Clip_Vertex polygon[CLIP_MAX_VERTICES] = {
+					{vertices_clip(vertices, i0), uv0, colors[0]},
+					{vertices_clip(vertices, i1), uv1, colors[1]},
+					{vertices_clip(vertices, i2), uv2, colors[2]},
+				};
+				auto polygon_count = clip_polygon(polygon, 3, planes, viewport_size);
+				if (polygon_count == 0)
+				{
+					++stats.triangles_culled_frustum;
 					continue;
+				}
 
-				auto z = w[0] * p0.z + w[1] * p1.z + w[2] * p2.z;
-				if (canvas_depth(self->canvas, (int)p.x, (int)p.y) > z)
+				for (int k = 1; k + 1 < polygon_count; ++k)
 				{
-					auto uv = w[0] * uv0 + w[1] * uv1 + w[2] * uv2;
-					auto color = canvas_color(self->texture, (int)(uv.x * self->texture.width), (int)((1.0f - uv.y) * self->texture.height));
-					canvas_color(self->canvas, (int)p.x, (int)p.y) = color * intensity;
-					canvas_depth(self->canvas, (int)p.x, (int)p.y) = z;
+					auto& c0 = polygon[0];
+					auto& c1 = polygon[k];
+					auto& c2 = polygon[k+1];
+					_triangle_submit(self, vertex_shader,
+						c0.position.xyz / c0.position.w, c1.position.xyz / c1.position.w, c2.position.xyz / c2.position.w,
+						c0.uv, c1.uv, c2.uv,
+						{c0.color, c1.color, c2.color}
+					);
 				}
 			}
+			else
+			{
+				_triangle_submit(self, vertex_shader, vertices_screen(vertices, i0), vertices_screen(vertices, i1), vertices_screen(vertices, i2), uv0, uv1, uv2, colors);
+			}
 		}
-	#endif
 	}
 
+	static void (*const _triangles_submit_permutations[SHADER_PERMUTATIONS])(Rex* self, math::V2 viewport_size) = shader_permutations(_triangles_submit);
+
 	inline static void
 	init(Rex_Api* api)
 	{
+		rex_profile_function();
+
 		auto self = (Rex*)api;
 
-		self->canvas = canvas_init();
+		// packed 8-bit so the blit is a copy, CANVAS_FORMAT_F32 keeps float color for hdr work
+		self->canvas = canvas_init(CANVAS_FORMAT_PIXEL);
 		self->cam = camera_init();
 
-		self->mesh = mesh_from_obj(rc::str_fmt(rc::frame_allocator(), "%s/data/african_head/african_head.obj", rc::app_directory()).ptr);
-		self->texture = canvas_init();
+		self->workers = rc::thread_pool_init();
+		self->vertices = vertices_init();
+		self->triangles = rc::vec_init<Triangle>();
+		self->tiles = tiles_init();
+		self->worker_stats = rc::vec_with_count<Raster_Stats>(rc::thread_pool_workers_count(self->workers));
+		self->cull_backfaces = true;
+		self->shader = SHADER_FLAG_DEFAULT;
+		self->vertex_normals = rc::vec_init<math::V3>();
+
+		self->mesh = mesh_load(rc::str_fmt(rc::frame_allocator(), "%s/data/african_head/african_head.obj", rc::app_directory()).ptr, self->workers);
+		self->sampler = Sampler{TEXTURE_FILTER_TRILINEAR, TEXTURE_WRAP_REPEAT};
 		{
 			int width, height, channels = 0;
-			auto data = stbi_load(rc::str_fmt(rc::frame_allocator(), "%s/data/african_head/african_head_diffuse.tga", rc::app_directory()).ptr, &width, &height, &channels, 4);
-			canvas_resize(self->texture, width, height);
-			for (int y = 0; y < height; ++y)
+			auto path = rc::str_fmt(rc::frame_allocator(), "%s/data/african_head/african_head_diffuse.tga", rc::app_directory());
+			auto data = stbi_load(path.ptr, &width, &height, &channels, 4);
+			if (data)
 			{
-				for (int x = 0; x < width; ++x)
-				{
-					canvas_color(self->texture, x, y).r = data[(x + y * width) * 4 + 0] / 255.0f;
-					canvas_color(self->texture, x, y).g = data[(x + y * width) * 4 + 1] / 255.0f;
-					canvas_color(self->texture, x, y).b = data[(x + y * width) * 4 + 2] / 255.0f;
-					canvas_color(self->texture, x, y).a = data[(x + y * width) * 4 + 3] / 255.0f;
-				}
+				self->texture = texture_from_rgba8(data, width, height);
+				stbi_image_free(data);
+			}
+			else
+			{
+				// keep rendering the geometry in plain white
+				rex_log_error("[rex-raster]: failed to load texture '%s'", path.ptr);
+				uint8_t white[4] = {255, 255, 255, 255};
+				self->texture = texture_from_rgba8(white, 1, 1);
 			}
 		}
 	}
@@ -176,7 +388,14 @@ namespace rex::raster
 	{
 		auto self = (Rex*)api;
 
-		canvas_deinit(self->texture);
+		rc::vec_deinit(self->worker_stats);
+		rc::vec_deinit(self->vertex_normals);
+		tiles_deinit(self->tiles);
+		rc::vec_deinit(self->triangles);
+		vertices_deinit(self->vertices);
+		rc::thread_pool_deinit(self->workers);
+
+		texture_deinit(self->texture);
 		canvas_deinit(self->canvas);
 		mesh_deinit(self->mesh);
 	}
@@ -184,6 +403,8 @@ namespace rex::raster
 	inline static void
 	loop(Rex_Api* api)
 	{
+		rex_profile_function();
+
 		auto self = (Rex*)api;
 		auto& canvas = self->canvas;
 		auto& mesh = self->mesh;
@@ -192,8 +413,15 @@ namespace rex::raster
 		// animation parameters
 		static float t = 0;
 
+		// minimized window, there is no screen to blit into
+		if (self->screen_width == 0 || self->screen_height == 0 || self->screen == nullptr)
+			return;
+
 		canvas_resize(canvas, self->screen_width, self->screen_height);
-		canvas_clear(canvas, {0.1f, 0.1f, 0.1f, 1.0f}, 1.0f);
+		if (self->shader & SHADER_FLAG_VISIBILITY)
+			canvas_visibility_resize(canvas);
+		tiles_resize(self->tiles, canvas.width, canvas.height);
+		rc::vec_clear(self->triangles);
 
 		camera_viewport_update(self->cam, canvas.width, canvas.height);
 		camera_input_update(self->cam, self->input, self->dt);
@@ -205,80 +433,48 @@ namespace rex::raster
 		float distance   = math::max(distance_w, distance_h);
 
 		self->cam.distance = distance;
+		// push the far plane out for models too big for the default depth range
+		self->cam.far = math::max(100.0f, (distance * self->cam.scale + max_length) * 2.0f);
 
 		auto M = math::mat4_translation(-mesh.bb_min - (mesh.bb_max - mesh.bb_min) * 0.5f);
 		auto V = camera_view_mat(self->cam);
 		auto P = camera_proj_mat(self->cam);
 		auto viewport = math::mat4_viewport<float>(0, 0, (float)canvas.width, (float)canvas.height);
+		auto viewport_size = math::V2{(float)canvas.width, (float)canvas.height};
 
-		auto count = (mesh.indices.count ? mesh.indices.count : mesh.position.count);
-		for (rc::sz i = 0; i < count; i += 3)
-		{
-			rc::sz i0, i1, i2;
-			if (mesh.indices.count)
-			{
-				i0 = mesh.indices[i+0];
-				i1 = mesh.indices[i+1];
-				i2 = mesh.indices[i+2];
-			}
-			else
-			{
-				i0 = i+0;
-				i1 = i+1;
-				i2 = i+2;
-			}
+		auto& stats = self->stats;
+		stats = {};
+		auto& timings = self->timings;
+		auto stage_start = rc::time_nanoseconds();
 
-			auto p0 = mesh.position[i0];
-			auto p1 = mesh.position[i1];
-			auto p2 = mesh.position[i2];
+		// the viewport keeps w so it can be applied before the perspective divide
+		auto MVPV = M * V * P * viewport;
+		vertices_transform(self->vertices, mesh.position, MVPV, viewport_size);
 
-			auto v0 = math::V4{p0.x, p0.y, p0.z, 1.0f} * M * V * P;
-			auto v1 = math::V4{p1.x, p1.y, p1.z, 1.0f} * M * V * P;
-			auto v2 = math::V4{p2.x, p2.y, p2.z, 1.0f} * M * V * P;
+		auto now = rc::time_nanoseconds();
+		timings.vertex_ns = now - stage_start;
+		rex_profile_record("vertex", stage_start, now);
+		stage_start = now;
 
-			v0 /= v0.w;
-			v1 /= v1.w;
-			v2 /= v2.w;
+		_triangles_submit_permutations[self->shader](self, viewport_size);
 
-			v0 *= viewport;
-			v1 *= viewport;
-			v2 *= viewport;
+		now = rc::time_nanoseconds();
+		timings.setup_ns = now - stage_start;
+		rex_profile_record("setup", stage_start, now);
+		stage_start = now;
 
-	#define WIREFRAME 0
-	#if WIREFRAME
-			_raster_line(self, {(int)v0_c.x, (int)v0_c.y}, {(int)v1_c.x, (int)v1_c.y}, {1.0f, 1.0f, 1.0f, 1.0f});
-			_raster_line(self, {(int)v1_c.x, (int)v1_c.y}, {(int)v2_c.x, (int)v2_c.y}, {1.0f, 1.0f, 1.0f, 1.0f});
-			_raster_line(self, {(int)v2_c.x, (int)v2_c.y}, {(int)v0_c.x, (int)v0_c.y}, {1.0f, 1.0f, 1.0f, 1.0f});
+		// rasterize tiles in parallel, each worker clears, rasterizes and blits its own tiles
+		rc::vec_fill(self->worker_stats, Raster_Stats{});
+		rc::thread_pool_run(self->workers, self->tiles.count_x * self->tiles.count_y, _raster_tile, self);
 
-	#else
-			math::V3 n0, n1, n2;
-			{
-				n0 = -math::cross(v2.xyz - v0.xyz, v1.xyz - v0.xyz);
-				n1 = n0; n2 = n1;
-			}
-			auto light_dir = math::V3{0.0f, 0.0f, -1.0f};
-			auto intensity = math::dot(math::normalize(n0), light_dir);
-			intensity = math::min(math::max(intensity, 0.0f), 1.0f);
-
-			auto uv0 = mesh.uv[mesh.uv_indices[i+0]];
-			auto uv1 = mesh.uv[mesh.uv_indices[i+1]];
-			auto uv2 = mesh.uv[mesh.uv_indices[i+2]];
-
-			_raster_triangle(self, v0.xyz, v1.xyz, v2.xyz,
-				uv0, uv1, uv2,
-				intensity
-			);
-	#endif
-		}
+		for (const auto& worker_stats: self->worker_stats)
+			raster_stats_add(stats, worker_stats);
 
-		// blit to screen
-		for (int i = 0; i < self->screen_width * self->screen_height; ++i)
-		{
-			self->screen[i].r = (uint8_t)(canvas.color[i].r * 255);
-			self->screen[i].g = (uint8_t)(canvas.color[i].g * 255);
-			self->screen[i].b = (uint8_t)(canvas.color[i].b * 255);
-			self->screen[i].a = 255;
-		}
+		now = rc::time_nanoseconds();
+		auto raster_ns = now - stage_start;
+		rex_profile_record("raster", stage_start, now);
+		timings.blit_ns = math::min(stats.blit_ns / self->worker_stats.count, raster_ns);
+		timings.raster_ns = raster_ns - timings.blit_ns;
 
 		// update t
 		t += dt;
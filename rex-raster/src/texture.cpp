@@ -0,0 +1,112 @@
+#include "rex-raster/texture.h"
+
+#include <rex-core/assert.h>
+#include <rex-core/pixels.h>
+#include <rex-core/profile.h>
+
+namespace rex::raster
+{
+	static constexpr rc::sz TEXTURE_ALIGNMENT = 64;
+	static constexpr rc::sz TEXELS_PER_LINE = TEXTURE_ALIGNMENT / sizeof(Texel);
+	static_assert(TEXTURE_TILE_SIZE * TEXTURE_TILE_SIZE * sizeof(Texel) == TEXTURE_ALIGNMENT, "a tile is a cache line");
+
+	// texels the level takes in memory, tiled levels are padded to whole tiles
+	inline static rc::sz
+	_texture_level_count(const Texture_Level& level, TEXTURE_LAYOUT layout)
+	{
+		if (layout == TEXTURE_LAYOUT_LINEAR)
+			return (rc::sz)level.width * level.height;
+		auto tiles_y = (level.height + TEXTURE_TILE_SIZE - 1) / TEXTURE_TILE_SIZE;
+		return (rc::sz)level.tiles_x * tiles_y * TEXTURE_TILE_SIZE * TEXTURE_TILE_SIZE;
+	}
+
+	// averages 2x2 texels of the previous level, odd sizes drop their last row or column except 1 texel
+	// wide ones which repeat it
+	inline static void
+	_texture_downsample(const Texture_Level& source, const Texture_Level& target, TEXTURE_LAYOUT layout)
+	{
+		auto texels = (Texel*)target.texels;
+		for (int y = 0; y < target.height; ++y)
+		{
+			auto y0 = y * 2, y1 = y * 2 + 1 < source.height ? y * 2 + 1 : y * 2;
+			for (int x = 0; x < target.width; ++x)
+			{
+				auto x0 = x * 2, x1 = x * 2 + 1 < source.width ? x * 2 + 1 : x * 2;
+				auto& t00 = source.texels[texture_index(source, layout, x0, y0)];
+				auto& t10 = source.texels[texture_index(source, layout, x1, y0)];
+				auto& t01 = source.texels[texture_index(source, layout, x0, y1)];
+				auto& t11 = source.texels[texture_index(source, layout, x1, y1)];
+				texels[texture_index(target, layout, x, y)] = Texel{
+					(uint8_t)((t00.r + t10.r + t01.r + t11.r + 2) >> 2),
+					(uint8_t)((t00.g + t10.g + t01.g + t11.g + 2) >> 2),
+					(uint8_t)((t00.b + t10.b + t01.b + t11.b + 2) >> 2),
+					(uint8_t)((t00.a + t10.a + t01.a + t11.a + 2) >> 2),
+				};
+			}
+		}
+	}
+
+	Texture
+	texture_from_rgba8(const uint8_t* data, int width, int height, TEXTURE_LAYOUT layout)
+	{
+		rex_profile_function();
+		rex_assert(data && width > 0 && height > 0);
+
+		Texture self = {};
+		self.texels = rc::vec_init<Texel>();
+		self.layout = layout;
+
+		// level sizes first so the whole chain is one allocation, every level is rounded up to whole cache
+		// lines and the extra line lets the first one start on a boundary
+		rc::sz offsets[TEXTURE_MAX_LEVELS] = {};
+		rc::sz count = 0;
+		for (int w = width, h = height; self.levels_count < TEXTURE_MAX_LEVELS; w = w > 1 ? w / 2 : 1, h = h > 1 ? h / 2 : 1)
+		{
+			auto& level = self.levels[self.levels_count];
+			level.width = w;
+			level.height = h;
+			level.tiles_x = (w + TEXTURE_TILE_SIZE - 1) / TEXTURE_TILE_SIZE;
+			offsets[self.levels_count] = count;
+			++self.levels_count;
+			count += (_texture_level_count(level, layout) + TEXELS_PER_LINE - 1) / TEXELS_PER_LINE * TEXELS_PER_LINE;
+			if (w == 1 && h == 1)
+				break;
+		}
+		rc::vec_resize(self.texels, count + TEXELS_PER_LINE);
+		rc::vec_fill(self.texels, Texel{});
+
+		auto misalignment = (rc::sz)(uintptr_t)self.texels.ptr % TEXTURE_ALIGNMENT;
+		auto base = self.texels.ptr + (misalignment ? (TEXTURE_ALIGNMENT - misalignment) / sizeof(Texel) : 0);
+		for (int i = 0; i < self.levels_count; ++i)
+			self.levels[i].texels = base + offsets[i];
+
+		auto& level0 = self.levels[0];
+		if (layout == TEXTURE_LAYOUT_LINEAR)
+		{
+			::memcpy(base, data, (rc::sz)width * height * sizeof(Texel));
+		}
+		else
+		{
+			auto rows = (const Texel*)data;
+			for (int y = 0; y < height; ++y)
+				for (int x = 0; x < width; ++x)
+					base[texture_index(level0, layout, x, y)] = rows[(rc::sz)y * width + x];
+		}
+
+		// premultiplied so the box filter and the bilinear taps don't bleed the color of transparent
+		// texels, the padding of tiled levels is transparent black either way
+		static_assert(sizeof(Texel) == sizeof(rc::u32), "a texel is a 4 byte pixel with alpha last");
+		rc::pixels_premultiply((const rc::u32*)base, (rc::u32*)base, _texture_level_count(level0, layout));
+
+		for (int i = 1; i < self.levels_count; ++i)
+			_texture_downsample(self.levels[i - 1], self.levels[i], layout);
+		return self;
+	}
+
+	void
+	texture_deinit(Texture& self)
+	{
+		rc::vec_deinit(self.texels);
+		self = {};
+	}
+}
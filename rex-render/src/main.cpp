@@ -0,0 +1,265 @@
+#include <rex-core/api.h>
+#include <rex-core/memory.h>
+#include <rex-core/str.h>
+#include <rex-core/thread.h>
+#include <rex-core/time.h>
+#include <rex-core/log.h>
+#include <rex-core/profile.h>
+
+#include <rex-math/math.h>
+#include <rex-raster/rex.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// renders frames without a window as fast as possible and writes them to disk, e.g.
+// rex-render --width 256 --height 256 --frames 36 --orbit 360 --output thumbs/head_%03d.ppm
+
+enum FORMAT
+{
+	FORMAT_PPM,
+	FORMAT_RAW,
+};
+
+struct Options
+{
+	int width, height;
+	int frames;
+	float dt;
+	// degrees the camera turns around the model over all the frames
+	float orbit;
+	FORMAT format;
+	// printf pattern that takes the frame index, no output renders without writing
+	const char* output;
+	// chrome trace json of the profiler zones, null doesn't profile
+	const char* trace;
+	// replaces the default model, null keeps it
+	const char* mesh;
+	rex::raster::TEXTURE_FILTER filter;
+	// SHADER_FLAG bits
+	rc::u32 shader;
+	bool wireframe;
+};
+
+inline static void
+_usage()
+{
+	fprintf(stderr,
+		"usage: rex-render [options]\n"
+		"  --width N         frame width (default 1280)\n"
+		"  --height N        frame height (default 720)\n"
+		"  --frames N        frames count (default 1)\n"
+		"  --dt SECONDS      simulated frame time (default 0.033)\n"
+		"  --orbit DEGREES   camera rotation around the model over all the frames (default 0)\n"
+		"  --format ppm|raw  raw is rgba8 without a header (default ppm)\n"
+		"  --output PATTERN  printf pattern of the frame path, e.g. out/frame_%%04d.ppm\n"
+		"  --trace PATH      write the profiler zones as chrome trace json\n"
+		"  --mesh PATH       .obj, .stl, .gltf, .glb or .rexmesh model to render instead of the default one\n"
+		"  --filter nearest|bilinear|trilinear  texture filtering (default trilinear)\n"
+		"  --shader LIST     comma separated depth,texture,gouraud,color,visibility or wireframe\n"
+		"                    (default depth,texture), visibility shades each visible pixel once\n"
+	);
+}
+
+// comma separated names of the shader flags, wireframe replaces the filled triangles
+inline static bool
+_shader_parse(Options& self, const char* value)
+{
+	self.shader = 0;
+	self.wireframe = false;
+	while (*value)
+	{
+		auto end = strchr(value, ',');
+		auto count = end ? (rc::sz)(end - value) : strlen(value);
+		if (count == 5 && strncmp(value, "depth", count) == 0)
+			self.shader |= rex::raster::SHADER_FLAG_DEPTH_TEST;
+		else if (count == 7 && strncmp(value, "texture", count) == 0)
+			self.shader |= rex::raster::SHADER_FLAG_TEXTURE;
+		else if (count == 7 && strncmp(value, "gouraud", count) == 0)
+			self.shader |= rex::raster::SHADER_FLAG_GOURAUD;
+		else if (count == 5 && strncmp(value, "color", count) == 0)
+			self.shader |= rex::raster::SHADER_FLAG_VERTEX_COLOR;
+		else if (count == 10 && strncmp(value, "visibility", count) == 0)
+			self.shader |= rex::raster::SHADER_FLAG_VISIBILITY;
+		else if (count == 9 && strncmp(value, "wireframe", count) == 0)
+			self.wireframe = true;
+		else
+			return false;
+		value += end ? count + 1 : count;
+	}
+	return true;
+}
+
+inline static bool
+_options_parse(Options& self, int argc, char** argv)
+{
+	self.width = 1280;
+	self.height = 720;
+	self.frames = 1;
+	self.dt = 0.033f;
+	self.orbit = 0.0f;
+	self.format = FORMAT_PPM;
+	self.output = nullptr;
+	self.trace = nullptr;
+	self.mesh = nullptr;
+	self.filter = rex::raster::TEXTURE_FILTER_TRILINEAR;
+	self.shader = rex::raster::SHADER_FLAG_DEFAULT;
+	self.wireframe = false;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		auto arg = argv[i];
+		auto value = i + 1 < argc ? argv[i + 1] : nullptr;
+		if (value == nullptr)
+			return false;
+
+		if (strcmp(arg, "--width") == 0)
+			self.width = atoi(value);
+		else if (strcmp(arg, "--height") == 0)
+			self.height = atoi(value);
+		else if (strcmp(arg, "--frames") == 0)
+			self.frames = atoi(value);
+		else if (strcmp(arg, "--dt") == 0)
+			self.dt = (float)atof(value);
+		else if (strcmp(arg, "--orbit") == 0)
+			self.orbit = (float)atof(value);
+		else if (strcmp(arg, "--format") == 0 && strcmp(value, "ppm") == 0)
+			self.format = FORMAT_PPM;
+		else if (strcmp(arg, "--format") == 0 && strcmp(value, "raw") == 0)
+			self.format = FORMAT_RAW;
+		else if (strcmp(arg, "--output") == 0)
+			self.output = value;
+		else if (strcmp(arg, "--trace") == 0)
+			self.trace = value;
+		else if (strcmp(arg, "--mesh") == 0)
+			self.mesh = value;
+		else if (strcmp(arg, "--filter") == 0 && strcmp(value, "nearest") == 0)
+			self.filter = rex::raster::TEXTURE_FILTER_NEAREST;
+		else if (strcmp(arg, "--filter") == 0 && strcmp(value, "bilinear") == 0)
+			self.filter = rex::raster::TEXTURE_FILTER_BILINEAR;
+		else if (strcmp(arg, "--filter") == 0 && strcmp(value, "trilinear") == 0)
+			self.filter = rex::raster::TEXTURE_FILTER_TRILINEAR;
+		else if (strcmp(arg, "--shader") == 0)
+		{
+			if (_shader_parse(self, value) == false)
+				return false;
+		}
+		else
+			return false;
+		++i;
+	}
+
+	return self.width > 0 && self.height > 0 && self.frames > 0;
+}
+
+inline static bool
+_frame_write(const Options& options, const Rex_Api* rex, int frame)
+{
+	auto path = rc::str_fmt(rc::frame_allocator(), options.output, frame);
+	auto file = fopen(path.ptr, "wb");
+	if (file == nullptr)
+	{
+		rex_log_error("[rex-render]: failed to open '%s'", path.ptr);
+		return false;
+	}
+
+	if (options.format == FORMAT_PPM)
+		fprintf(file, "P6\n%d %d\n255\n", rex->screen_width, rex->screen_height);
+
+	// convert a row at a time from the screen byte order
+	auto channels = options.format == FORMAT_PPM ? 3 : 4;
+	auto row = rex_alloc_N_from(rc::frame_allocator(), uint8_t, (rc::sz)rex->screen_width * channels);
+	for (int y = 0; y < rex->screen_height; ++y)
+	{
+		auto pixels = rex->screen + (rc::sz)y * rex->screen_width;
+		for (int x = 0; x < rex->screen_width; ++x)
+		{
+			row[x * channels + 0] = pixels[x].r;
+			row[x * channels + 1] = pixels[x].g;
+			row[x * channels + 2] = pixels[x].b;
+			if (channels == 4)
+				row[x * channels + 3] = pixels[x].a;
+		}
+		fwrite(row, 1, (rc::sz)rex->screen_width * channels, file);
+	}
+
+	fclose(file);
+	return true;
+}
+
+int main(int argc, char** argv)
+{
+	// TODO: make sure memory allocators initialized first
+	rc::rex_allocator();
+
+	Options options = {};
+	if (_options_parse(options, argc, argv) == false)
+	{
+		_usage();
+		return 1;
+	}
+
+	rc::profile_enable(options.trace != nullptr);
+	rc::profile_frame_mark();
+
+	auto rex = load_rex_api();
+	rex->init(rex);
+
+	rex->screen_width = options.width;
+	rex->screen_height = options.height;
+	rex->screen = rex_alloc_N(Rex_Pixel, (rc::sz)options.width * options.height);
+	rex->dt = options.dt;
+
+	auto self = (rex::raster::Rex*)rex;
+	self->sampler.filter = options.filter;
+	self->shader = options.shader;
+	self->wireframe = options.wireframe;
+	if (options.mesh)
+	{
+		auto mesh = rex::raster::mesh_load(options.mesh, self->workers);
+		if (mesh.position.count == 0)
+		{
+			rex_log_error("[rex-render]: failed to load mesh '%s'", options.mesh);
+			rex_dealloc(rex->screen);
+			rex->deinit(rex);
+			return 1;
+		}
+		rex::raster::mesh_deinit(self->mesh);
+		self->mesh = mesh;
+	}
+
+	// the headless driver owns the camera instead of feeding it input
+	auto& cam = self->cam;
+	auto orbit_step = options.orbit * (float)rex::math::TO_RADIAN / options.frames;
+
+	rc::u64 render_ns = 0;
+	for (int frame = 0; frame < options.frames; ++frame)
+	{
+		cam.rotation.y = orbit_step * frame;
+
+		auto start = rc::time_nanoseconds();
+		rex->loop(rex);
+		render_ns += rc::time_nanoseconds() - start;
+
+		if (options.output && _frame_write(options, rex, frame) == false)
+			break;
+
+		rc::frame_allocator()->clear();
+		rc::profile_frame_mark();
+	}
+
+	if (options.trace)
+		rc::profile_dump_chrome_trace(options.trace);
+
+	auto cores = rc::thread_cores_count();
+	auto seconds = render_ns * 1e-9;
+	auto frames_per_second = options.frames / seconds;
+	fprintf(stderr, "[rex-render]: %d frames %dx%d in %.3fs, %.3f ms/frame, %.2f frames/s, %.2f frames/s per core (%u cores)\n",
+		options.frames, options.width, options.height, seconds, seconds * 1000.0 / options.frames,
+		frames_per_second, frames_per_second / cores, cores);
+
+	rex_dealloc(rex->screen);
+	rex->deinit(rex);
+	return 0;
+}
@@ -0,0 +1,61 @@
+#include <rex-core/file.h>
+#include <rex-core/defer.h>
+
+#include "doctest.h"
+
+#include <stdio.h>
+#include <string.h>
+
+TEST_CASE("[rex-core]: file")
+{
+	static constexpr const char* FILE_PATH = "utests_file_map.txt";
+
+	SUBCASE("file map")
+	{
+		const char content[] = "v 1 2 3\nv 4 5 6\n";
+		auto file = fopen(FILE_PATH, "wb");
+		REQUIRE(file != nullptr);
+		fwrite(content, 1, sizeof(content) - 1, file);
+		fclose(file);
+		rex_defer(remove(FILE_PATH));
+
+		auto map = rc::file_map(FILE_PATH);
+		REQUIRE(map.ptr != nullptr);
+		CHECK(map.count == sizeof(content) - 1);
+		CHECK(memcmp(map.ptr, content, map.count) == 0);
+
+		rc::file_unmap(map);
+		CHECK(map.ptr == nullptr);
+		CHECK(map.count == 0);
+	}
+
+	SUBCASE("file map empty")
+	{
+		auto file = fopen(FILE_PATH, "wb");
+		REQUIRE(file != nullptr);
+		fclose(file);
+		rex_defer(remove(FILE_PATH));
+
+		auto map = rc::file_map(FILE_PATH);
+		CHECK(map.ptr != nullptr);
+		CHECK(map.count == 0);
+		rc::file_unmap(map);
+	}
+
+	SUBCASE("file map missing")
+	{
+		auto map = rc::file_map("utests_file_map_missing.txt");
+		CHECK(map.ptr == nullptr);
+		rc::file_unmap(map);
+	}
+
+	SUBCASE("file has extension")
+	{
+		CHECK(rc::file_has_extension("data/girl/scene.gltf", ".gltf"));
+		CHECK(rc::file_has_extension("HEAD.OBJ", ".obj"));
+		CHECK(rc::file_has_extension(".obj", ".obj"));
+		CHECK(rc::file_has_extension("scene.gltf", ".glb") == false);
+		CHECK(rc::file_has_extension("scene.gltf.rexmesh", ".gltf") == false);
+		CHECK(rc::file_has_extension("obj", ".obj") == false);
+	}
+}
@@ -0,0 +1,156 @@
+#include <rex-core/json.h>
+#include <rex-core/defer.h>
+
+#include "doctest.h"
+
+#include <string.h>
+
+inline static rc::Json_Document
+_parse(const char* text)
+{
+	return rc::json_parse(text, text + strlen(text));
+}
+
+TEST_CASE("[rex-core]: json")
+{
+	SUBCASE("json scalars")
+	{
+		auto document = _parse(" [null, true, false, -12.5e1, 0, \"text\"] ");
+		rex_defer(rc::json_deinit(document));
+
+		REQUIRE(document.root != nullptr);
+		CHECK(document.root->type == rc::JSON_ARRAY);
+		CHECK(rc::json_count(document.root) == 6);
+		CHECK(rc::json_at(document.root, 0)->type == rc::JSON_NULL);
+		CHECK(rc::json_bool(rc::json_at(document.root, 1), false) == true);
+		CHECK(rc::json_bool(rc::json_at(document.root, 2), true) == false);
+		CHECK(rc::json_number(rc::json_at(document.root, 3), 0.0) == -125.0);
+		CHECK(rc::json_number(rc::json_at(document.root, 4), 1.0) == 0.0);
+		CHECK(rc::json_string_equals(rc::json_at(document.root, 5), "text"));
+		CHECK(rc::json_at(document.root, 6) == nullptr);
+	}
+
+	SUBCASE("json nested containers")
+	{
+		auto text = "{\"meshes\": [{\"primitives\": [{\"attributes\": {\"POSITION\": 0, \"NORMAL\": 1}, \"indices\": 2}]}], \"empty\": {}, \"list\": []}";
+		auto document = _parse(text);
+		rex_defer(rc::json_deinit(document));
+
+		REQUIRE(document.root != nullptr);
+		CHECK(document.root->type == rc::JSON_OBJECT);
+		CHECK(document.root->count == 3);
+
+		auto primitive = rc::json_at(rc::json_find(rc::json_at(rc::json_find(document.root, "meshes"), 0), "primitives"), 0);
+		auto attributes = rc::json_find(primitive, "attributes");
+		CHECK(rc::json_number(rc::json_find(attributes, "POSITION"), -1.0) == 0.0);
+		CHECK(rc::json_number(rc::json_find(attributes, "NORMAL"), -1.0) == 1.0);
+		CHECK(rc::json_find(attributes, "TEXCOORD_0") == nullptr);
+		CHECK(rc::json_number(rc::json_find(primitive, "indices"), -1.0) == 2.0);
+
+		auto empty = rc::json_find(document.root, "empty");
+		REQUIRE(empty != nullptr);
+		CHECK(empty->type == rc::JSON_OBJECT);
+		CHECK(empty->count == 0);
+		CHECK(rc::json_count(rc::json_find(document.root, "list")) == 0);
+
+		// keys are views into the text
+		CHECK(document.root->values[0].key == strstr(text, "meshes"));
+		CHECK(document.root->values[0].key_count == 6);
+	}
+
+	SUBCASE("json strings are views with their escapes")
+	{
+		auto text = "{\"a\\\"b\": \"line\\nnext \\u00e9\\ud83d\\ude00 \\\\\"}";
+		auto document = _parse(text);
+		rex_defer(rc::json_deinit(document));
+
+		REQUIRE(document.root != nullptr);
+		auto value = rc::json_find(document.root, "a\\\"b");
+		REQUIRE(value != nullptr);
+		CHECK(value->type == rc::JSON_STRING);
+		CHECK(value->as_string > text);
+		CHECK(value->as_string < text + strlen(text));
+
+		auto unescaped = rc::json_unescape(*value);
+		rex_defer(rc::str_deinit(unescaped));
+		CHECK(unescaped == "line\nnext \xC3\xA9\xF0\x9F\x98\x80 \\");
+	}
+
+	SUBCASE("json invalid unescape")
+	{
+		auto document = _parse("[\"\\ud83d\", \"\\x\"]");
+		rex_defer(rc::json_deinit(document));
+
+		REQUIRE(document.root != nullptr);
+		auto lone_surrogate = rc::json_unescape(*rc::json_at(document.root, 0));
+		rex_defer(rc::str_deinit(lone_surrogate));
+		CHECK(lone_surrogate.count == 0);
+		auto unknown = rc::json_unescape(*rc::json_at(document.root, 1));
+		rex_defer(rc::str_deinit(unknown));
+		CHECK(unknown.count == 0);
+	}
+
+	SUBCASE("json invalid documents")
+	{
+		const char* texts[] = {"", "   ", "[1, 2", "[1 2]", "{\"a\" 1}", "{1: 2}", "[1,]", "tru", "[-]", "[inf]", "[nan]", "\"open", "[] []", "[+1]"};
+		for (auto text: texts)
+		{
+			auto document = _parse(text);
+			CHECK_MESSAGE(document.root == nullptr, text);
+			rc::json_deinit(document);
+		}
+	}
+
+	SUBCASE("json depth limit")
+	{
+		char deep[rc::JSON_MAX_DEPTH + 1 + 1 + rc::JSON_MAX_DEPTH + 1] = {};
+		for (rc::u32 i = 0; i <= rc::JSON_MAX_DEPTH; ++i)
+		{
+			deep[i] = '[';
+			deep[rc::JSON_MAX_DEPTH + 1 + i] = ']';
+		}
+		auto too_deep = rc::json_parse(deep, deep + 2 * (rc::JSON_MAX_DEPTH + 1));
+		CHECK(too_deep.root == nullptr);
+		rc::json_deinit(too_deep);
+
+		auto limit = rc::json_parse(deep + 1, deep + 2 * rc::JSON_MAX_DEPTH + 1);
+		CHECK(limit.root != nullptr);
+		rc::json_deinit(limit);
+	}
+
+	SUBCASE("json sax")
+	{
+		struct Counts
+		{
+			int begins, ends, values;
+			double sum;
+			rc::u32 last_count;
+		};
+
+		rc::Json_Events events = {};
+		events.begin = [](void* data, const rc::Json&) { ++((Counts*)data)->begins; return true; };
+		events.end = [](void* data, const rc::Json& value) { ++((Counts*)data)->ends; ((Counts*)data)->last_count = value.count; return true; };
+		events.value = [](void* data, const rc::Json& value) {
+			auto counts = (Counts*)data;
+			++counts->values;
+			if (value.type == rc::JSON_NUMBER)
+				counts->sum += value.as_number;
+			return true;
+		};
+
+		auto text = "{\"a\": [1, 2, {\"b\": 3}], \"c\": \"4\", \"d\": null}";
+		Counts counts = {};
+		CHECK(rc::json_sax(text, text + strlen(text), events, &counts));
+		CHECK(counts.begins == 3);
+		CHECK(counts.ends == 3);
+		CHECK(counts.values == 5);
+		CHECK(counts.sum == 6.0);
+		CHECK(counts.last_count == 3);
+
+		// a callback returning false stops the parse
+		events.value = [](void*, const rc::Json& value) { return value.type != rc::JSON_NULL; };
+		counts = {};
+		CHECK(rc::json_sax(text, text + strlen(text), events, &counts) == false);
+		CHECK(counts.ends == 2);
+	}
+}
@@ -0,0 +1,122 @@
+#include <rex-core/pixels.h>
+
+#include "doctest.h"
+
+#include <math.h>
+
+// counts around the simd widths so both the vector loops and the scalar tails run
+static constexpr rc::sz COUNTS[] = {0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100};
+
+TEST_CASE("[rex-core]: pixels")
+{
+	SUBCASE("u8 to f32")
+	{
+		rc::u8 src[256];
+		for (int i = 0; i < 256; ++i)
+			src[i] = (rc::u8)i;
+
+		float dst[256];
+		rc::pixels_u8_to_f32(src, dst, 256);
+		for (int i = 0; i < 256; ++i)
+			CHECK(dst[i] == (float)i / 255.0f);
+	}
+
+	SUBCASE("f32 to u8 clamps and truncates")
+	{
+		float src[100];
+		for (int i = 0; i < 100; ++i)
+			src[i] = (float)i / 50.0f - 0.5f;
+		src[7] = NAN;
+		src[8] = INFINITY;
+		src[9] = -INFINITY;
+
+		for (auto count: COUNTS)
+		{
+			rc::u8 dst[101] = {};
+			dst[count] = 0xAB;
+			rc::pixels_f32_to_u8(src, dst, count);
+			for (rc::sz i = 0; i < count; ++i)
+			{
+				auto c = src[i] > 0.0f ? (src[i] < 1.0f ? src[i] : 1.0f) : 0.0f;
+				CHECK(dst[i] == (rc::u8)(c * 255.0f));
+			}
+			CHECK(dst[count] == 0xAB);
+		}
+	}
+
+	SUBCASE("f32 to u8 round trip")
+	{
+		rc::u8 src[256];
+		for (int i = 0; i < 256; ++i)
+			src[i] = (rc::u8)(255 - i);
+
+		float f[256];
+		rc::u8 dst[256];
+		rc::pixels_u8_to_f32(src, f, 256);
+		rc::pixels_f32_to_u8(f, dst, 256);
+		for (int i = 0; i < 256; ++i)
+			CHECK(dst[i] == src[i]);
+	}
+
+	SUBCASE("swizzle rb")
+	{
+		rc::u32 src[100];
+		for (rc::u32 i = 0; i < 100; ++i)
+			src[i] = 0x01020304u * (i + 1);
+
+		for (auto count: COUNTS)
+		{
+			rc::u32 dst[101] = {};
+			rc::pixels_swizzle_rb(src, dst, count);
+			for (rc::sz i = 0; i < count; ++i)
+			{
+				CHECK((dst[i] & 0xFF) == ((src[i] >> 16) & 0xFF));
+				CHECK(((dst[i] >> 16) & 0xFF) == (src[i] & 0xFF));
+				CHECK((dst[i] & 0xFF00FF00u) == (src[i] & 0xFF00FF00u));
+			}
+			CHECK(dst[count] == 0);
+
+			// swizzling again in place gives the source back
+			rc::pixels_swizzle_rb(dst, dst, count);
+			for (rc::sz i = 0; i < count; ++i)
+				CHECK(dst[i] == src[i]);
+		}
+	}
+
+	SUBCASE("premultiply")
+	{
+		// every channel against every alpha, 256 alphas of 86 pixels
+		static rc::u32 src[256 * 86];
+		rc::sz count = 0;
+		for (rc::u32 a = 0; a < 256; ++a)
+		{
+			for (rc::u32 c = 0; c < 256; c += 3)
+			{
+				auto g = (c + 1) & 0xFF, b = (c + 2) & 0xFF;
+				src[count++] = c | (g << 8) | (b << 16) | (a << 24);
+			}
+		}
+
+		static rc::u32 dst[256 * 86];
+		rc::pixels_premultiply(src, dst, count);
+		for (rc::sz i = 0; i < count; ++i)
+		{
+			auto a = src[i] >> 24;
+			CHECK((dst[i] >> 24) == a);
+			for (int shift = 0; shift < 24; shift += 8)
+			{
+				auto c = (src[i] >> shift) & 0xFF;
+				CHECK(((dst[i] >> shift) & 0xFF) == (rc::u32)lround(c * a / 255.0));
+			}
+		}
+
+		for (auto n: COUNTS)
+		{
+			rc::u32 tail[101] = {};
+			rc::pixels_premultiply(src + 1000, tail, n);
+			for (rc::sz i = 0; i < n; ++i)
+				CHECK(tail[i] == dst[1000 + i]);
+			CHECK(tail[n] == 0);
+		}
+	}
+}
@@ -0,0 +1,45 @@
+#include <rex-core/profile.h>
+#include <rex-core/file.h>
+#include <rex-core/defer.h>
+
+#include "doctest.h"
+
+#include <stdio.h>
+#include <string.h>
+
+TEST_CASE("[rex-core]: profile")
+{
+	static constexpr const char* TRACE_PATH = "utests_profile_trace.json";
+
+	SUBCASE("disabled zones aren't recorded")
+	{
+		rc::profile_enable(false);
+		rc::Profile_Zone zone("utests_disabled_zone");
+		CHECK(zone.name == nullptr);
+	}
+
+	SUBCASE("chrome trace of the last frames")
+	{
+		rc::profile_enable(true);
+		rex_defer(rc::profile_enable(false));
+
+		rc::profile_frame_mark();
+		rc::profile_zone_record("utests_old_zone", rc::time_nanoseconds(), rc::time_nanoseconds());
+		rc::profile_frame_mark();
+		{
+			rc::Profile_Zone zone("utests_new_zone");
+			CHECK(zone.name != nullptr);
+		}
+		rc::profile_frame_mark();
+
+		REQUIRE(rc::profile_dump_chrome_trace(TRACE_PATH, 1));
+		rex_defer(::remove(TRACE_PATH));
+
+		auto trace = rc::file_read(TRACE_PATH);
+		rex_defer(rc::str_deinit(trace));
+		REQUIRE(trace.ptr != nullptr);
+		CHECK(::strstr(trace.ptr, "\"traceEvents\"") != nullptr);
+		CHECK(::strstr(trace.ptr, "\"utests_new_zone\", \"ph\": \"X\"") != nullptr);
+		CHECK(::strstr(trace.ptr, "utests_old_zone") == nullptr);
+	}
+}
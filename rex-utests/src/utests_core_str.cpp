@@ -3,6 +3,12 @@
 
 #include "doctest.h"
 
+#include <locale.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
 TEST_CASE("[rex-core]: str")
 {
 	SUBCASE("str initialization")
@@ -269,6 +275,115 @@ TEST_CASE("[rex-core]: str")
 
 		CHECK((rc::str_to_double(rc::str_lit("-1.0e4"), &result) == doctest::Approx(-10000) && result == true));
 		CHECK((rc::str_to_double(rc::str_lit("-1.0e-4"), &result) == doctest::Approx(-0.0001) && result == true));
+
+		CHECK((rc::str_to_double(rc::str_lit("+2.5E2"), &result) == 250.0 && result == true));
+		CHECK((rc::str_to_double(rc::str_lit("1e"), &result) == 0 && result == false));
+		CHECK((rc::str_to_double(rc::str_lit("."), &result) == 0 && result == false));
+		CHECK((rc::str_to_double(rc::str_lit("-"), &result) == 0 && result == false));
+	}
+
+	SUBCASE("str parse double")
+	{
+		auto parse = [](const char* c_str, double expected, rc::sz expected_count) {
+			double value = 0.0;
+			auto count = rc::str_parse_double(c_str, c_str + rc::str_len(c_str), &value);
+			return count == expected_count && value == expected;
+		};
+
+		// correctly rounded, the old multiply by 0.1 loop was off by ulps on these
+		CHECK(parse("0.1", 0.1, 3));
+		CHECK(parse("123.4567", 123.4567, 8));
+		CHECK(parse("0.3e-5", 0.3e-5, 6));
+		CHECK(parse("9007199254740993", 9007199254740992.0, 16));
+		CHECK(parse("2.2250738585072011e-308", 2.2250738585072011e-308, 23));
+		CHECK(parse("4.9e-324", 4.9e-324, 8));
+		CHECK(parse("1.7976931348623157e308", 1.7976931348623157e308, 22));
+		CHECK(parse("123456789012345678901234567890", 123456789012345678901234567890.0, 30));
+		CHECK(parse("1e-400", 0.0, 6));
+		CHECK(parse("1e400", HUGE_VAL, 5));
+		CHECK(parse("-Infinity", -HUGE_VAL, 9));
+		CHECK(parse("inf ", HUGE_VAL, 3));
+
+		// stops at the first character that isn't part of the number
+		CHECK(parse("1.5/2/3", 1.5, 3));
+		CHECK(parse("7e+", 7.0, 1));
+		CHECK(parse("5.", 5.0, 2));
+
+		double value = 0.0;
+		CHECK(rc::str_parse_double("nan", "nan" + 3, &value) == 3);
+		CHECK(value != value);
+		CHECK(rc::str_parse_double("x1", "x1" + 2, &value) == 0);
+		CHECK(rc::str_parse_double("+.e3", "+.e3" + 4, &value) == 0);
+	}
+
+	SUBCASE("str parse double slow path")
+	{
+		// bit exact against the c library in the c locale, which is correctly rounded
+		auto same = [](const char* c_str) {
+			double value = 0.0;
+			auto count = rc::str_parse_double(c_str, c_str + rc::str_len(c_str), &value);
+			auto expected = ::strtod(c_str, nullptr);
+			return count == rc::str_len(c_str) && ::memcmp(&value, &expected, sizeof(value)) == 0;
+		};
+
+		// the exact halfway point between 1 and the next double rounds to even, anything above it rounds up
+		// even 900 digits later
+		auto halfway = rc::str_from("1.00000000000000011102230246251565404236316680908203125");
+		rex_defer(rc::str_deinit(halfway));
+		CHECK(same(halfway.ptr));
+		for (int i = 0; i < 900; ++i)
+			rc::str_append(halfway, "0");
+		CHECK(same(halfway.ptr));
+		rc::str_append(halfway, "1");
+		CHECK(same(halfway.ptr));
+		rc::str_append(halfway, "e5");
+		CHECK(same(halfway.ptr));
+
+		CHECK(same("9007199254740993.00000000000000000001"));
+		CHECK(same("9007199254740992.99999999999999999999"));
+		CHECK(same("9007199254740993000000000000000000000e-21"));
+		CHECK(same("2.4703282292062327208828439643411068618252990130716238221279284125033775363510437593264991818081799618989828234772285886546332835517796989819938739800539093906315035659515570226392290858392449105184435931802849936536152500319370457678249219365623669863658480757001585769269903706311928279558551332927834338409351978015531246597263579574622766465272827220056374006485499977096599470454020828166226237857393450736339007967761930577506740176324673600968951340535537458516661134223766678604162159680461914467291840300530057530849048765391711386591646239524912623653881879636239373280423891018672348497668235089863388587925628302755995657524455507255189313690836254779186948667994968324049705821028513185451396213837722826145437693412532098591327667236328125e-324"));
+		CHECK(same("2.4703282292062327208828439643411068618252990130716238221279284125033775363510437593264991818081799618989828234772285886546332835517796989819938739800539093906315035659515570226392290858392449105184435931802849936536152500319370457678249219365623669863658480757001585769269903706311928279558551332927834338409351978015531246597263579574622766465272827220056374006485499977096599470454020828166226237857393450736339007967761930577506740176324673600968951340535537458516661134223766678604162159680461914467291840300530057530849048765391711386591646239524912623653881879636239373280423891018672348497668235089863388587925628302755995657524455507255189313690836254779186948667994968324049705821028513185451396213837722826145437693412532098591327667236328126e-324"));
+		CHECK(same("1.7976931348623158079372897140530341507993413271003782693617377898044496829276475094664736e308"));
+		CHECK(same("1.7976931348623158079372897140530341507993413271003782693617377898044496829276475094664737e308"));
+		CHECK(same("0.000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000002225073858507201136057409796709131975934819546351645648023426109724822222021076945516529523908135087914149158913039621106870086438694594645527657207407820621743379988141063267329253552286881372149012981122451451889849057222307285255133155755015914397476397983411801999323962548289017107081850690630666655994938275772572015763062690663332647565300009245888316433037779791869612049497390377829704905051080609940730262937128958950003583799967207254304360284078895771796150945516748243471030702609144621572289880258182545180325707018860872113128079512233426288368622321503775666622503982534335974568884423900265498198385487948292206894721689831099698365846814022854243330660339850886445804001034933970427567186443383770486037861622771738545623065874679014086723327636718751"));
+
+		// random lengths and exponents, most take the fast paths and some the exact one
+		rc::u32 state = 2463534242u;
+		auto next = [&state]() {
+			state ^= state << 13;
+			state ^= state >> 17;
+			state ^= state << 5;
+			return state;
+		};
+		bool ok = true;
+		for (int i = 0; i < 20000; ++i)
+		{
+			char buffer[64];
+			int count = 0;
+			auto digits = 1 + (int)(next() % 30);
+			auto point = (int)(next() % (rc::u32)(digits + 1));
+			for (int k = 0; k < digits; ++k)
+			{
+				if (k == point)
+					buffer[count++] = '.';
+				buffer[count++] = (char)('0' + next() % 10);
+			}
+			count += snprintf(buffer + count, sizeof(buffer) - count, "e%d", (int)(next() % 700) - 350);
+			ok &= same(buffer);
+		}
+		CHECK(ok);
+
+		// a locale with a comma decimal separator doesn't change anything, if the system has one
+		if (::setlocale(LC_NUMERIC, "de_DE.UTF-8") || ::setlocale(LC_NUMERIC, "fr_FR.UTF-8"))
+		{
+			double value = 0.0;
+			auto c_str = halfway.ptr;
+			rc::str_parse_double(c_str, c_str + halfway.count, &value);
+			::setlocale(LC_NUMERIC, "C");
+			CHECK(same(c_str));
+			CHECK(value == ::strtod(c_str, nullptr));
+		}
 	}
 
 	SUBCASE("str to int")
@@ -281,6 +396,9 @@ TEST_CASE("[rex-core]: str")
 		CHECK((rc::str_to_int(rc::str_lit("123456789"), &result) == 123456789LL && result == true));
 		CHECK((rc::str_to_int(rc::str_lit("-123456789"), &result) == -123456789LL && result == true));
 		CHECK((rc::str_to_int(rc::str_lit("w13"), &result) == 0 && result == false));
+		CHECK((rc::str_to_int(rc::str_lit("+42"), &result) == 42 && result == true));
+		CHECK((rc::str_to_int(rc::str_lit("-9223372036854775808"), &result) == rc::I64_MIN && result == true));
+		CHECK((rc::str_to_int(rc::str_lit("9223372036854775808"), &result) == 0 && result == false));
 	}
 
 	SUBCASE("str equal")
@@ -0,0 +1,57 @@
+#include <rex-core/thread.h>
+#include <rex-core/defer.h>
+
+#include "doctest.h"
+
+struct Tasks
+{
+	rc::u32 values[1000];
+	rc::u32 workers[1000];
+};
+
+inline static void
+_task(void* user_data, rc::u32 index, rc::u32 worker)
+{
+	auto tasks = (Tasks*)user_data;
+	tasks->values[index] += index;
+	tasks->workers[index] = worker;
+}
+
+TEST_CASE("[rex-core]: thread")
+{
+	SUBCASE("cores count")
+	{
+		CHECK(rc::thread_cores_count() >= 1);
+	}
+
+	SUBCASE("thread pool runs every task once")
+	{
+		auto pool = rc::thread_pool_init(4);
+		rex_defer(rc::thread_pool_deinit(pool));
+
+		CHECK(rc::thread_pool_workers_count(pool) >= 1);
+
+		Tasks tasks = {};
+		for (int run = 0; run < 10; ++run)
+			rc::thread_pool_run(pool, 1000, _task, &tasks);
+
+		bool values_ok = true, workers_ok = true;
+		for (rc::u32 i = 0; i < 1000; ++i)
+		{
+			values_ok &= tasks.values[i] == i * 10;
+			workers_ok &= tasks.workers[i] < rc::thread_pool_workers_count(pool);
+		}
+		CHECK(values_ok);
+		CHECK(workers_ok);
+	}
+
+	SUBCASE("thread pool with no tasks")
+	{
+		auto pool = rc::thread_pool_init();
+		rex_defer(rc::thread_pool_deinit(pool));
+
+		Tasks tasks = {};
+		rc::thread_pool_run(pool, 0, _task, &tasks);
+		CHECK(tasks.values[0] == 0);
+	}
+}
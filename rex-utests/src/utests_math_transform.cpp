@@ -0,0 +1,62 @@
+#include <rex-math/transform.h>
+#include <rex-math/mat4.h>
+#include <rex-math/vec3.h>
+#include <rex-math/vec4.h>
+
+#include "doctest.h"
+
+TEST_CASE("[rex-math]: transform")
+{
+	rex::math::M4 M = {
+		 1.0f,  2.0f,  3.0f,  0.5f,
+		 5.0f,  6.0f,  7.0f, -1.0f,
+		 9.0f, 10.0f, 11.0f,  0.0f,
+		13.0f, 14.0f, 15.0f,  4.0f
+	};
+
+	// not a multiple of the simd width so the tail is covered as well
+	constexpr int COUNT = 11;
+	rex::math::V3 points[COUNT];
+	for (int i = 0; i < COUNT; ++i)
+		points[i] = {(float)i, (float)(i * 2) - 5.0f, 0.25f * (float)i};
+
+	SUBCASE("transform points")
+	{
+		float x[COUNT], y[COUNT], z[COUNT], w[COUNT];
+		rex::math::mat4_transform_points(M, points, COUNT, {x, y, z, w});
+
+		bool ok = true;
+		for (int i = 0; i < COUNT; ++i)
+		{
+			auto v = rex::math::V4{points[i].x, points[i].y, points[i].z, 1.0f} * M;
+			ok &= x[i] == v.x && y[i] == v.y && z[i] == v.z && w[i] == v.w;
+		}
+		CHECK(ok);
+	}
+
+	SUBCASE("project points")
+	{
+		float x[COUNT], y[COUNT], z[COUNT], w[COUNT];
+		float sx[COUNT], sy[COUNT], sz[COUNT];
+		rex::math::mat4_project_points(M, points, COUNT, {x, y, z, w}, {sx, sy, sz});
+
+		bool ok = true;
+		for (int i = 0; i < COUNT; ++i)
+		{
+			auto v = rex::math::V4{points[i].x, points[i].y, points[i].z, 1.0f} * M;
+			// the kernels multiply by the reciprocal of w, which can be 1 ulp away from dividing by w
+			auto inv_w = 1.0f / v.w;
+			auto s = rex::math::V3{v.x * inv_w, v.y * inv_w, v.z * inv_w};
+			ok &= x[i] == v.x && y[i] == v.y && z[i] == v.z && w[i] == v.w;
+			ok &= sx[i] == s.x && sy[i] == s.y && sz[i] == s.z;
+		}
+		CHECK(ok);
+	}
+
+	SUBCASE("no points")
+	{
+		float x[1] = {7.0f}, y[1], z[1], w[1];
+		rex::math::mat4_transform_points(M, points, 0, {x, y, z, w});
+		CHECK(x[0] == 7.0f);
+	}
+}
@@ -0,0 +1,204 @@
+#include <rex-raster/gltf.h>
+
+#include <rex-core/defer.h>
+#include <rex-core/memory.h>
+#include <rex-core/path.h>
+
+#include "doctest.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+using namespace rex;
+using namespace rex::raster;
+
+static constexpr const char* FILE_PATH = "utests_gltf.glb";
+
+// the quad's corners, then the strip, fan and out of range u16 indices
+struct Glb_Bin
+{
+	float positions[4][3];
+	uint16_t strip[4];
+	uint16_t fan[4];
+	uint16_t invalid[4];
+};
+
+static const Glb_Bin BIN = {
+	{{0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {1.0f, 1.0f, 0.0f}},
+	{0, 1, 2, 3},
+	{0, 1, 3, 2},
+	{0, 1, 7, 0},
+};
+
+#define GLB_BUFFERS \
+	"\"asset\":{\"version\":\"2.0\"}," \
+	"\"buffers\":[{\"byteLength\":72}]," \
+	"\"bufferViews\":[" \
+		"{\"buffer\":0,\"byteOffset\":0,\"byteLength\":48}," \
+		"{\"buffer\":0,\"byteOffset\":48,\"byteLength\":8}," \
+		"{\"buffer\":0,\"byteOffset\":56,\"byteLength\":8}," \
+		"{\"buffer\":0,\"byteOffset\":64,\"byteLength\":8}],"
+
+// glb header, the json chunk padded with spaces and the binary chunk
+inline static bool
+_glb_write(const char* json)
+{
+	auto json_count = (uint32_t)::strlen(json);
+	auto json_padded = (json_count + 3) & ~3u;
+	uint32_t header[3] = {0x46546C67, 2, (uint32_t)(12 + 8 + json_padded + 8 + sizeof(BIN))};
+	uint32_t json_chunk[2] = {json_padded, 0x4E4F534A};
+	uint32_t bin_chunk[2] = {(uint32_t)sizeof(BIN), 0x004E4942};
+
+	auto file = fopen(FILE_PATH, "wb");
+	if (file == nullptr)
+		return false;
+	fwrite(header, sizeof(header), 1, file);
+	fwrite(json_chunk, sizeof(json_chunk), 1, file);
+	fwrite(json, 1, json_count, file);
+	fwrite("   ", 1, json_padded - json_count, file);
+	fwrite(bin_chunk, sizeof(bin_chunk), 1, file);
+	fwrite(&BIN, sizeof(BIN), 1, file);
+	return fclose(file) == 0;
+}
+
+// z of the triangle's face normal
+inline static float
+_triangle_z(const Mesh& mesh, rc::sz triangle)
+{
+	auto a = mesh.position[mesh.indices[triangle * 3 + 0]];
+	auto b = mesh.position[mesh.indices[triangle * 3 + 1]];
+	auto c = mesh.position[mesh.indices[triangle * 3 + 2]];
+	return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+}
+
+TEST_CASE("[rex-raster]: gltf")
+{
+	SUBCASE("strips, fans and mirrored nodes")
+	{
+		REQUIRE(_glb_write("{" GLB_BUFFERS
+			"\"accessors\":["
+				"{\"bufferView\":0,\"componentType\":5126,\"count\":4,\"type\":\"VEC3\"},"
+				"{\"bufferView\":1,\"componentType\":5123,\"count\":4,\"type\":\"SCALAR\"},"
+				"{\"bufferView\":2,\"componentType\":5123,\"count\":4,\"type\":\"SCALAR\"}],"
+			"\"meshes\":[{\"primitives\":["
+				"{\"attributes\":{\"POSITION\":0},\"indices\":1,\"mode\":5},"
+				"{\"attributes\":{\"POSITION\":0},\"indices\":2,\"mode\":6}]}],"
+			"\"nodes\":[{\"mesh\":0},{\"mesh\":0,\"scale\":[-1,1,1]}],"
+			"\"scenes\":[{\"nodes\":[0,1]}]}"));
+		rex_defer(remove(FILE_PATH));
+
+		auto mesh = mesh_from_gltf(FILE_PATH);
+		rex_defer(mesh_deinit(mesh));
+
+		// every instance has its own copy of both primitives' vertices
+		REQUIRE(mesh.position.count == 16);
+		REQUIRE(mesh.indices.count == 24);
+		CHECK(mesh.position[9].x == -1.0f);
+		CHECK(mesh.bb_min.x == -1.0f);
+		CHECK(mesh.bb_max.x == 1.0f);
+
+		// odd strip triangles swap their first corners, the mirrored instance swaps the last two of each
+		unsigned expected[] = {
+			0, 1, 2, 2, 1, 3, 5, 7, 4, 7, 6, 4,
+			8, 10, 9, 10, 11, 9, 13, 12, 15, 15, 12, 14,
+		};
+		for (rc::sz i = 0; i < mesh.indices.count; ++i)
+		{
+			CAPTURE(i);
+			CHECK(mesh.indices[i] == expected[i]);
+		}
+
+		// so every triangle still faces +z
+		for (rc::sz i = 0; i < mesh.indices.count / 3; ++i)
+		{
+			CAPTURE(i);
+			CHECK(_triangle_z(mesh, i) > 0.0f);
+		}
+	}
+
+	SUBCASE("accessor out of its view")
+	{
+		REQUIRE(_glb_write("{" GLB_BUFFERS
+			"\"accessors\":["
+				"{\"bufferView\":0,\"componentType\":5126,\"count\":5,\"type\":\"VEC3\"}],"
+			"\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0}}]}],"
+			"\"nodes\":[{\"mesh\":0}],"
+			"\"scenes\":[{\"nodes\":[0]}]}"));
+		rex_defer(remove(FILE_PATH));
+
+		auto gltf = gltf_from_file(FILE_PATH);
+		CHECK(gltf.accessors.count == 0);
+		CHECK(gltf.instances.count == 0);
+		gltf_deinit(gltf);
+
+		auto mesh = mesh_from_gltf(FILE_PATH);
+		CHECK(mesh.position.count == 0);
+		CHECK(mesh.indices.count == 0);
+		mesh_deinit(mesh);
+	}
+
+	SUBCASE("index out of the vertices")
+	{
+		REQUIRE(_glb_write("{" GLB_BUFFERS
+			"\"accessors\":["
+				"{\"bufferView\":0,\"componentType\":5126,\"count\":4,\"type\":\"VEC3\"},"
+				"{\"bufferView\":3,\"componentType\":5123,\"count\":4,\"type\":\"SCALAR\"}],"
+			"\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0},\"indices\":1,\"mode\":5}]}],"
+			"\"nodes\":[{\"mesh\":0}],"
+			"\"scenes\":[{\"nodes\":[0]}]}"));
+		rex_defer(remove(FILE_PATH));
+
+		auto mesh = mesh_from_gltf(FILE_PATH);
+		CHECK(mesh.position.count == 0);
+		CHECK(mesh.indices.count == 0);
+		mesh_deinit(mesh);
+	}
+
+	SUBCASE("node cycles and shared children")
+	{
+		// 0 and 1 are each other's child, 2 fans out to 3 which fans out to 4 several times
+		REQUIRE(_glb_write("{" GLB_BUFFERS
+			"\"accessors\":["
+				"{\"bufferView\":0,\"componentType\":5126,\"count\":4,\"type\":\"VEC3\"}],"
+			"\"meshes\":[{\"primitives\":[{\"attributes\":{\"POSITION\":0}}]}],"
+			"\"nodes\":["
+				"{\"mesh\":0,\"children\":[1]},"
+				"{\"mesh\":0,\"children\":[0,2,1]},"
+				"{\"children\":[3,3,3,3,3,3,3,3]},"
+				"{\"children\":[4,4,4,4,4,4,4,4]},"
+				"{\"mesh\":0,\"children\":[-1,9]}],"
+			"\"scenes\":[{\"nodes\":[0,2,4]}]}"));
+		rex_defer(remove(FILE_PATH));
+
+		auto gltf = gltf_from_file(FILE_PATH);
+		CHECK(gltf.meshes.count == 1);
+		CHECK(gltf.instances.count == 3);
+		gltf_deinit(gltf);
+	}
+}
+
+// the sample scene deployed next to the binaries, a node tree with several meshes and materials
+TEST_CASE("[rex-raster]: gltf girl")
+{
+	auto path = rc::str_fmt(rc::frame_allocator(), "%s/data/girl/scene.gltf", rc::app_directory());
+	auto mesh = mesh_from_gltf(path.ptr);
+	rex_defer(mesh_deinit(mesh));
+
+	REQUIRE(mesh.position.count == 72209);
+	REQUIRE(mesh.indices.count == 129786 * 3);
+	CHECK(mesh.uv.count == mesh.position.count);
+	CHECK(mesh.uv_indices.count == mesh.indices.count);
+
+	unsigned max_index = 0;
+	for (auto index: mesh.indices)
+		max_index = index > max_index ? index : max_index;
+	CHECK(max_index < mesh.position.count);
+
+	CHECK(mesh.bb_min.x == doctest::Approx(-27.5545f).epsilon(0.0001));
+	CHECK(mesh.bb_min.y == doctest::Approx(-0.176041f).epsilon(0.0001));
+	CHECK(mesh.bb_min.z == doctest::Approx(-24.9871f).epsilon(0.0001));
+	CHECK(mesh.bb_max.x == doctest::Approx(24.3056f).epsilon(0.0001));
+	CHECK(mesh.bb_max.y == doctest::Approx(86.7313f).epsilon(0.0001));
+	CHECK(mesh.bb_max.z == doctest::Approx(19.1566f).epsilon(0.0001));
+}
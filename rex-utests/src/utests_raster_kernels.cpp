@@ -0,0 +1,197 @@
+#include <rex-raster/raster.h>
+
+#include <rex-core/cpu.h>
+#include <rex-core/defer.h>
+
+#include "doctest.h"
+
+#include <string.h>
+
+using namespace rex;
+using namespace rex::raster;
+
+// not multiples of the tile or span widths so the kernels run their partial spans on the right edge
+static constexpr int WIDTH = 203;
+static constexpr int HEIGHT = 141;
+
+inline static float
+_random(rc::u32& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return (float)(state % 10000) / 10000.0f;
+}
+
+// overlapping triangles of every size with varying depth and uvs, the last one reaches far out of the
+// canvas so its edges overflow 32-bit and take the scalar fallback. like the frame, the permutations
+// without varying color get one color per triangle since their kernels only read it at the origin
+inline static void
+_scene_triangles(rc::Vec<Triangle>& triangles, bool varying_color)
+{
+	rc::vec_clear(triangles);
+	rc::u32 state = 2463534242u;
+	for (int i = 0; i < 60; ++i)
+	{
+		auto size = i < 40 ? 12.0f : 120.0f;
+		auto cx = _random(state) * WIDTH, cy = _random(state) * HEIGHT;
+
+		Triangle triangle = {};
+		math::V3* p[3] = {&triangle.p0, &triangle.p1, &triangle.p2};
+		math::V2* uv[3] = {&triangle.uv0, &triangle.uv1, &triangle.uv2};
+		math::Color_F32 colors[3];
+		for (int k = 0; k < 3; ++k)
+		{
+			*p[k] = {cx + (_random(state) - 0.5f) * size, cy + (_random(state) - 0.5f) * size, _random(state)};
+			*uv[k] = {_random(state) * 2.0f, _random(state) * 2.0f};
+			colors[k] = {_random(state), _random(state), _random(state), 1.0f};
+			if (varying_color == false)
+				colors[k] = colors[0];
+		}
+		if (triangle_setup(triangle, WIDTH, HEIGHT, false, colors) == TRIANGLE_CULL_NONE)
+			rc::vec_push(triangles, triangle);
+	}
+
+	math::Color_F32 colors[3] = {{1.0f, 0.0f, 0.0f, 1.0f}, {0.0f, 1.0f, 0.0f, 1.0f}, {0.0f, 0.0f, 1.0f, 1.0f}};
+	if (varying_color == false)
+		colors[1] = colors[2] = colors[0];
+	Triangle huge = {};
+	huge.p0 = {-1.0e6f, -1.0e6f, 0.3f};
+	huge.p1 = {1.0e6f, 10.0f, 0.6f};
+	huge.p2 = {20.0f, 1.0e6f, 0.9f};
+	huge.uv1 = {1.0f, 0.0f};
+	huge.uv2 = {0.0f, 1.0f};
+	if (triangle_setup(huge, WIDTH, HEIGHT, false, colors) == TRIANGLE_CULL_NONE)
+		rc::vec_push(triangles, huge);
+}
+
+// renders every triangle tile by tile like the frame does
+inline static void
+_render(Rex* self, const raster_triangle_proc* kernels, rc::u32 shader)
+{
+	auto& canvas = self->canvas;
+	canvas_clear(canvas, {0.1f, 0.1f, 0.1f, 1.0f}, 1.0f);
+	canvas_visibility_clear(canvas, {0, 0}, {WIDTH - 1, HEIGHT - 1});
+
+	Raster_Stats stats = {};
+	for (int ty = 0; ty < HEIGHT; ty += TILE_SIZE)
+	{
+		for (int tx = 0; tx < WIDTH; tx += TILE_SIZE)
+		{
+			math::V2i tile_min = {tx, ty};
+			math::V2i tile_max = {math::min(tx + TILE_SIZE, WIDTH) - 1, math::min(ty + TILE_SIZE, HEIGHT) - 1};
+			for (const auto& triangle: self->triangles)
+				raster_triangle(self, kernels[shader], shader, triangle, tile_min, tile_max, stats);
+		}
+	}
+}
+
+TEST_CASE("[rex-raster]: kernels")
+{
+	Rex self = {};
+	self.triangles = rc::vec_init<Triangle>();
+
+	uint8_t texels[37 * 23 * 4];
+	rc::u32 state = 88172645u;
+	for (auto& t: texels)
+		t = (uint8_t)(_random(state) * 255.0f);
+
+	// the kernels fetch whole spans of texels, every filter, wrap and layout must match the scalar fetch.
+	// the first one runs every shader, the others only the textured ones
+	struct Texturing
+	{
+		int width, height;
+		TEXTURE_LAYOUT layout;
+		Sampler sampler;
+	};
+	Texturing texturings[] = {
+		{32, 32, TEXTURE_LAYOUT_TILED, {TEXTURE_FILTER_TRILINEAR, TEXTURE_WRAP_REPEAT}},
+		{37, 23, TEXTURE_LAYOUT_TILED, {TEXTURE_FILTER_NEAREST, TEXTURE_WRAP_REPEAT}},
+		{37, 23, TEXTURE_LAYOUT_TILED, {TEXTURE_FILTER_BILINEAR, TEXTURE_WRAP_CLAMP}},
+		{37, 23, TEXTURE_LAYOUT_LINEAR, {TEXTURE_FILTER_NEAREST, TEXTURE_WRAP_CLAMP}},
+		{37, 23, TEXTURE_LAYOUT_LINEAR, {TEXTURE_FILTER_BILINEAR, TEXTURE_WRAP_REPEAT}},
+		{37, 23, TEXTURE_LAYOUT_LINEAR, {TEXTURE_FILTER_TRILINEAR, TEXTURE_WRAP_CLAMP}},
+		{5, 3, TEXTURE_LAYOUT_TILED, {TEXTURE_FILTER_TRILINEAR, TEXTURE_WRAP_REPEAT}},
+	};
+
+	struct Kernels
+	{
+		const char* name;
+		const raster_triangle_proc* table;
+		bool supported;
+	};
+
+	auto features = rc::cpu_features();
+	(void)features;
+	Kernels kernels[] = {
+	#if REX_ARCH_X86
+		{"sse4", raster_triangle_sse4, features.sse41},
+		{"avx2", raster_triangle_avx2, features.avx2},
+	#endif
+		{"scalar", raster_triangle_scalar, true},
+	};
+
+	for (auto format: {CANVAS_FORMAT_PIXEL, CANVAS_FORMAT_F32})
+	{
+		self.canvas = canvas_init(format);
+		canvas_resize(self.canvas, WIDTH, HEIGHT);
+		canvas_visibility_resize(self.canvas);
+
+		auto pixels = rc::vec_init<Rex_Pixel>();
+		auto colors = rc::vec_init<math::Color_F32>();
+		auto depth = rc::vec_init<float>();
+		auto visibility = rc::vec_init<rc::u32>();
+		for (const auto& texturing: texturings)
+		{
+			for (rc::u32 shader = 0; shader < SHADER_PERMUTATIONS; ++shader)
+			{
+				if (&texturing != texturings && (shader & SHADER_FLAG_TEXTURE) == 0)
+					continue;
+
+				self.texture = texture_from_rgba8(texels, texturing.width, texturing.height, texturing.layout);
+				rex_defer(texture_deinit(self.texture));
+				self.sampler = texturing.sampler;
+
+				_scene_triangles(self.triangles, (shader & (SHADER_FLAG_GOURAUD | SHADER_FLAG_VERTEX_COLOR)) != 0);
+				REQUIRE(self.triangles.count > 40);
+
+				// the scalar kernels are the reference
+				_render(&self, raster_triangle_scalar, shader);
+				rc::vec_resize(pixels, self.canvas.pixels.count);
+				rc::vec_resize(colors, self.canvas.color.count);
+				rc::vec_resize(depth, self.canvas.depth.count);
+				rc::vec_resize(visibility, self.canvas.visibility.count);
+				::memcpy(pixels.ptr, self.canvas.pixels.ptr, pixels.count * sizeof(*pixels.ptr));
+				::memcpy(colors.ptr, self.canvas.color.ptr, colors.count * sizeof(*colors.ptr));
+				::memcpy(depth.ptr, self.canvas.depth.ptr, depth.count * sizeof(*depth.ptr));
+				::memcpy(visibility.ptr, self.canvas.visibility.ptr, visibility.count * sizeof(*visibility.ptr));
+
+				for (const auto& k: kernels)
+				{
+					if (k.supported == false)
+						continue;
+
+					CAPTURE(k.name);
+					CAPTURE(shader);
+					CAPTURE(texturing.width);
+					CAPTURE((int)texturing.layout);
+					CAPTURE((int)texturing.sampler.filter);
+					CAPTURE((int)texturing.sampler.wrap);
+					CAPTURE((int)format);
+					_render(&self, k.table, shader);
+					CHECK(::memcmp(pixels.ptr, self.canvas.pixels.ptr, pixels.count * sizeof(*pixels.ptr)) == 0);
+					CHECK(::memcmp(colors.ptr, self.canvas.color.ptr, colors.count * sizeof(*colors.ptr)) == 0);
+					CHECK(::memcmp(depth.ptr, self.canvas.depth.ptr, depth.count * sizeof(*depth.ptr)) == 0);
+					CHECK(::memcmp(visibility.ptr, self.canvas.visibility.ptr, visibility.count * sizeof(*visibility.ptr)) == 0);
+				}
+			}
+		}
+		rc::vec_deinit(pixels);
+		rc::vec_deinit(colors);
+		rc::vec_deinit(depth);
+		rc::vec_deinit(visibility);
+		canvas_deinit(self.canvas);
+	}
+
+	rc::vec_deinit(self.triangles);
+}
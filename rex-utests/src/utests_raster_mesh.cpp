@@ -0,0 +1,299 @@
+#include <rex-raster/mesh.h>
+
+#include <rex-core/defer.h>
+#include <rex-core/str.h>
+#include <rex-core/thread.h>
+
+#include "doctest.h"
+
+#include <stdio.h>
+#include <string.h>
+
+using namespace rex;
+using namespace rex::raster;
+
+inline static float
+_random(rc::u32& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return (float)(state % 20000) / 10000.0f - 1.0f;
+}
+
+template <typename T>
+inline static bool
+_vec_equal(const rc::Vec<T>& a, const rc::Vec<T>& b)
+{
+	return a.count == b.count && (a.count == 0 || ::memcmp(a.ptr, b.ptr, a.count * sizeof(T)) == 0);
+}
+
+// blocks of records mixing every face form the parser handles, lines alternate between crlf and lf
+inline static rc::Str
+_obj_text(int blocks)
+{
+	// formatted appends grow the string to fit exactly, reserve the whole text once instead
+	auto self = rc::str_init();
+	rc::vec_reserve(self, (rc::sz)blocks * 512);
+	rc::u32 state = 2463534242u;
+	int line = 0;
+	auto eol = [&]() { rc::str_append(self, (line++ % 3) == 0 ? "\r\n" : "\n"); };
+
+	rc::str_append(self, "# generated\r\n");
+	for (int i = 0; i < blocks; ++i)
+	{
+		for (int k = 0; k < 4; ++k)
+		{
+			rc::str_append(self, "v %.7g %.7g %.7g", _random(state), _random(state) * 100.0f, _random(state) * 1.0e-3f);
+			eol();
+		}
+		for (int k = 0; k < 4; ++k)
+		{
+			rc::str_append(self, "vt %.6f %.6f", _random(state), _random(state));
+			eol();
+		}
+		rc::str_append(self, "vn %.7g %.7g %.7g", _random(state), _random(state), _random(state));
+		eol();
+
+		// quad with uvs and relative indices
+		rc::str_append(self, "f -4/-4 -3/-3 -2/-2 -1/-1");
+		eol();
+		// relative v//vn triangle
+		rc::str_append(self, "f\t-4//-1  -2//-1 -1//-1 ");
+		eol();
+		// absolute v//vn quad, the normal is the first one so it's always there
+		int p = i * 4 + 1;
+		rc::str_append(self, "f %d//1 %d//1 %d//1 %d//1", p, p + 1, p + 2, p + 3);
+		eol();
+		// absolute v/vt/vn triangle
+		rc::str_append(self, "f %d/%d/%d %d/%d/%d %d/%d/%d", p + 3, p + 3, i + 1, p + 1, p + 1, i + 1, p, p, i + 1);
+		eol();
+		rc::str_append(self, "# block %d", i);
+		eol();
+	}
+	return self;
+}
+
+TEST_CASE("[rex-raster]: mesh")
+{
+	SUBCASE("obj chunked parse")
+	{
+		static constexpr const char* FILE_PATH = "utests_mesh_chunks.obj";
+		static constexpr int BLOCKS = 10000;
+
+		// a few MiB so the pooled parse splits it into several chunks
+		auto text = _obj_text(BLOCKS);
+		rex_defer(rc::str_deinit(text));
+
+		auto file = fopen(FILE_PATH, "wb");
+		REQUIRE(file != nullptr);
+		fwrite(text.ptr, 1, text.count, file);
+		fclose(file);
+		rex_defer(remove(FILE_PATH));
+
+		auto workers = rc::thread_pool_init(4);
+		rex_defer(rc::thread_pool_deinit(workers));
+		REQUIRE(rc::thread_pool_workers_count(workers) > 1);
+
+		// the split points mesh_from_obj starts from before moving to the next line, none of them is already
+		// a line start so every chunk boundary cuts through a line
+		rc::sz chunks_count = text.count >> 20;
+		rc::sz by_workers = rc::thread_pool_workers_count(workers) * 4;
+		chunks_count = chunks_count < by_workers ? chunks_count : by_workers;
+		REQUIRE(chunks_count > 2);
+		for (rc::sz i = 1; i < chunks_count; ++i)
+			REQUIRE(text[text.count / chunks_count * i - 1] != '\n');
+
+		auto serial = mesh_from_obj(FILE_PATH);
+		rex_defer(mesh_deinit(serial));
+		auto pooled = mesh_from_obj(FILE_PATH, workers);
+		rex_defer(mesh_deinit(pooled));
+
+		// the v//vn faces use the default uv appended after the file's ones
+		CHECK(serial.position.count == BLOCKS * 4);
+		CHECK(serial.uv.count == BLOCKS * 4 + 1);
+		CHECK(serial.normal.count == BLOCKS);
+		CHECK(serial.indices.count == BLOCKS * (6 + 3 + 6 + 3));
+		CHECK(serial.uv_indices.count == serial.indices.count);
+
+		unsigned first_uvs[] = {0, 1, 2, 0, 2, 3, BLOCKS * 4, BLOCKS * 4, BLOCKS * 4};
+		REQUIRE(serial.uv_indices.count >= 9);
+		for (int i = 0; i < 9; ++i)
+			CHECK(serial.uv_indices[i] == first_uvs[i]);
+		CHECK(serial.uv[BLOCKS * 4].x == 0.5f);
+		CHECK(serial.uv[BLOCKS * 4].y == 0.5f);
+
+		// the first block resolves to the same vertices with relative and absolute indices
+		unsigned first_block[] = {0, 1, 2, 0, 2, 3, 0, 2, 3, 0, 1, 2, 0, 2, 3, 3, 1, 0};
+		REQUIRE(serial.indices.count >= 18);
+		for (int i = 0; i < 18; ++i)
+			CHECK(serial.indices[i] == first_block[i]);
+		CHECK(serial.indices[serial.indices.count - 1] == BLOCKS * 4 - 4);
+
+		CHECK(_vec_equal(serial.position, pooled.position));
+		CHECK(_vec_equal(serial.normal, pooled.normal));
+		CHECK(_vec_equal(serial.uv, pooled.uv));
+		CHECK(_vec_equal(serial.color, pooled.color));
+		CHECK(_vec_equal(serial.indices, pooled.indices));
+		CHECK(_vec_equal(serial.uv_indices, pooled.uv_indices));
+		CHECK(::memcmp(&serial.bb_min, &pooled.bb_min, sizeof(serial.bb_min)) == 0);
+		CHECK(::memcmp(&serial.bb_max, &pooled.bb_max, sizeof(serial.bb_max)) == 0);
+	}
+
+	SUBCASE("obj invalid records")
+	{
+		static constexpr const char* FILE_PATH = "utests_mesh_invalid.obj";
+
+		// every one of these logs and loads as an empty mesh instead of crashing
+		const char* texts[] = {
+			"v 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 3\n",
+			"v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 9\n",
+			"v 0 0 0\nv 1 0 0\nv 0 1 0\nf -1 -2 -4\n",
+			"v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 0\n",
+			"v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2\n",
+			"v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2x 3\n",
+			"v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0 0\nf 1/1 2/2 3/1\n",
+			"v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0\nf 1 2 3\n",
+		};
+		for (auto text: texts)
+		{
+			CAPTURE(text);
+			auto file = fopen(FILE_PATH, "wb");
+			REQUIRE(file != nullptr);
+			fwrite(text, 1, ::strlen(text), file);
+			fclose(file);
+
+			auto mesh = mesh_from_obj(FILE_PATH);
+			CHECK(mesh.position.count == 0);
+			CHECK(mesh.indices.count == 0);
+			CHECK(mesh.uv_indices.count == 0);
+			mesh_deinit(mesh);
+		}
+		remove(FILE_PATH);
+	}
+
+	SUBCASE("obj mixed uvs")
+	{
+		static constexpr const char* FILE_PATH = "utests_mesh_mixed.obj";
+
+		// a textured face, untextured ones and a vt without its optional v
+		const char text[] = "v 0 0 0\nv 1 0 0\nv 0 1 0\nvt 0.25 0.5\nvt 1\nf 1/1 2/2 3/1\nf 1 2 3\nf 3 2 1\n";
+		auto file = fopen(FILE_PATH, "wb");
+		REQUIRE(file != nullptr);
+		fwrite(text, 1, sizeof(text) - 1, file);
+		fclose(file);
+		rex_defer(remove(FILE_PATH));
+
+		auto mesh = mesh_from_obj(FILE_PATH);
+		rex_defer(mesh_deinit(mesh));
+		REQUIRE(mesh.indices.count == 9);
+		REQUIRE(mesh.uv_indices.count == 9);
+		REQUIRE(mesh.uv.count == 3);
+		CHECK(mesh.uv[1].x == 1.0f);
+		CHECK(mesh.uv[1].y == 0.0f);
+		CHECK(mesh.uv[2].x == 0.5f);
+		CHECK(mesh.uv[2].y == 0.5f);
+
+		unsigned uv_indices[] = {0, 1, 0, 2, 2, 2, 2, 2, 2};
+		for (int i = 0; i < 9; ++i)
+			CHECK(mesh.uv_indices[i] == uv_indices[i]);
+	}
+
+	SUBCASE("rexmesh round trip")
+	{
+		static constexpr const char* FILE_PATH = "utests_mesh.rexmesh";
+
+		// odd counts so every array after the first needs padding to its aligned offset
+		auto mesh = mesh_init();
+		mesh.uv_indices = rc::vec_init<unsigned>();
+		rex_defer(mesh_deinit(mesh));
+		rc::u32 state = 88172645u;
+		for (int i = 0; i < 7; ++i)
+			rc::vec_push(mesh.position, math::V3{_random(state), _random(state), _random(state)});
+		for (int i = 0; i < 3; ++i)
+			rc::vec_push(mesh.normal, math::V3{_random(state), _random(state), _random(state)});
+		for (int i = 0; i < 5; ++i)
+			rc::vec_push(mesh.uv, math::V2{_random(state), _random(state)});
+		for (unsigned i = 0; i < 9; ++i)
+			rc::vec_push(mesh.indices, i % 7);
+		for (unsigned i = 0; i < 9; ++i)
+			rc::vec_push(mesh.uv_indices, i % 5);
+		mesh.bb_min = {-1.0f, -1.0f, -1.0f};
+		mesh.bb_max = {1.0f, 1.0f, 1.0f};
+
+		REQUIRE(mesh_save_rexmesh(mesh, FILE_PATH, rc::File_Info{}));
+		rex_defer(remove(FILE_PATH));
+
+		auto loaded = mesh_from_rexmesh(FILE_PATH);
+		rex_defer(mesh_deinit(loaded));
+		REQUIRE(loaded.storage.ptr != nullptr);
+
+		CHECK(_vec_equal(mesh.position, loaded.position));
+		CHECK(_vec_equal(mesh.normal, loaded.normal));
+		CHECK(_vec_equal(mesh.uv, loaded.uv));
+		CHECK(_vec_equal(mesh.color, loaded.color));
+		CHECK(_vec_equal(mesh.indices, loaded.indices));
+		CHECK(_vec_equal(mesh.uv_indices, loaded.uv_indices));
+		CHECK(::memcmp(&mesh.bb_min, &loaded.bb_min, sizeof(mesh.bb_min)) == 0);
+		CHECK(::memcmp(&mesh.bb_max, &loaded.bb_max, sizeof(mesh.bb_max)) == 0);
+
+		// the last array ends the file
+		auto info = rc::file_info(FILE_PATH);
+		CHECK(info.size == (rc::u64)((const char*)(loaded.uv_indices.ptr + loaded.uv_indices.count) - loaded.storage.ptr));
+	}
+
+	SUBCASE("rexmesh invalid indices")
+	{
+		static constexpr const char* FILE_PATH = "utests_mesh_invalid.rexmesh";
+
+		auto mesh = mesh_init();
+		mesh.uv_indices = rc::vec_init<unsigned>();
+		rex_defer(mesh_deinit(mesh));
+		for (int i = 0; i < 4; ++i)
+		{
+			rc::vec_push(mesh.position, math::V3{(float)i, 0.0f, 0.0f});
+			rc::vec_push(mesh.uv, math::V2{(float)i, 0.0f});
+		}
+		for (unsigned i: {0u, 1u, 2u, 0u, 2u, 3u})
+		{
+			rc::vec_push(mesh.indices, i);
+			rc::vec_push(mesh.uv_indices, i);
+		}
+
+		// saving doesn't check, loading must reject every one of these
+		enum CORRUPTION
+		{
+			CORRUPTION_NONE,
+			CORRUPTION_INDEX,
+			CORRUPTION_UV_INDEX,
+			CORRUPTION_UV_INDICES_COUNT,
+			CORRUPTION_INDICES_COUNT,
+			CORRUPTION_COUNT,
+		};
+		for (int corruption = CORRUPTION_NONE; corruption < CORRUPTION_COUNT; ++corruption)
+		{
+			CAPTURE(corruption);
+			auto copy = mesh_init();
+			copy.uv_indices = rc::vec_init<unsigned>();
+			rc::vec_append(copy.position, mesh.position);
+			rc::vec_append(copy.uv, mesh.uv);
+			rc::vec_append(copy.indices, mesh.indices);
+			rc::vec_append(copy.uv_indices, mesh.uv_indices);
+			switch (corruption)
+			{
+				case CORRUPTION_INDEX: copy.indices[4] = 4; break;
+				case CORRUPTION_UV_INDEX: copy.uv_indices[5] = 100; break;
+				case CORRUPTION_UV_INDICES_COUNT: rc::vec_pop(copy.uv_indices); break;
+				case CORRUPTION_INDICES_COUNT: rc::vec_pop(copy.indices); rc::vec_pop(copy.uv_indices); break;
+			}
+			REQUIRE(mesh_save_rexmesh(copy, FILE_PATH));
+			mesh_deinit(copy);
+
+			auto loaded = mesh_from_rexmesh(FILE_PATH);
+			CHECK((loaded.position.count != 0) == (corruption == CORRUPTION_NONE));
+			CHECK((loaded.storage.ptr != nullptr) == (corruption == CORRUPTION_NONE));
+			mesh_deinit(loaded);
+		}
+		remove(FILE_PATH);
+	}
+}
@@ -0,0 +1,163 @@
+#include <rex-raster/pipeline.h>
+
+#include "doctest.h"
+
+using namespace rex;
+using namespace rex::raster;
+
+static constexpr int WIDTH = 64;
+static constexpr int HEIGHT = 64;
+
+// adds one to every pixel of hits the triangle covers, with the same inside test as the kernels
+inline static void
+_triangle_hits(math::V2 p0, math::V2 p1, math::V2 p2, int (&hits)[HEIGHT][WIDTH])
+{
+	math::Color_F32 colors[3] = {{1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}, {1.0f, 1.0f, 1.0f, 1.0f}};
+	Triangle triangle = {};
+	triangle.p0 = {p0.x, p0.y, 0.5f};
+	triangle.p1 = {p1.x, p1.y, 0.5f};
+	triangle.p2 = {p2.x, p2.y, 0.5f};
+	if (triangle_setup(triangle, WIDTH, HEIGHT, false, colors) != TRIANGLE_CULL_NONE)
+		return;
+
+	auto& e = triangle.edges;
+	for (int y = triangle.bb_min.y; y <= triangle.bb_max.y; ++y)
+	{
+		for (int x = triangle.bb_min.x; x <= triangle.bb_max.x; ++x)
+		{
+			rc::i64 w[3];
+			for (int i = 0; i < 3; ++i)
+				w[i] = e[i].a * x + e[i].b * y + e[i].c + e[i].bias;
+			if ((w[0] | w[1] | w[2]) >= 0)
+				++hits[y][x];
+		}
+	}
+}
+
+inline static int
+_hits_max(const int (&hits)[HEIGHT][WIDTH])
+{
+	int self = 0;
+	for (auto& row: hits)
+		for (auto h: row)
+			self = h > self ? h : self;
+	return self;
+}
+
+inline static int
+_hits_count(const int (&hits)[HEIGHT][WIDTH])
+{
+	int self = 0;
+	for (auto& row: hits)
+		for (auto h: row)
+			self += h;
+	return self;
+}
+
+TEST_CASE("[rex-raster]: fill rule")
+{
+	static int hits[HEIGHT][WIDTH];
+	for (auto& row: hits)
+		for (auto& h: row)
+			h = 0;
+
+	SUBCASE("quad split along its diagonal")
+	{
+		// the edges run exactly through pixel centers, the left and top ones own them
+		math::V2 a = {2.5f, 2.5f}, b = {12.5f, 2.5f}, c = {12.5f, 12.5f}, d = {2.5f, 12.5f};
+		_triangle_hits(a, b, c, hits);
+		_triangle_hits(a, c, d, hits);
+
+		CHECK(_hits_max(hits) == 1);
+		CHECK(_hits_count(hits) == 100);
+		for (int y = 2; y < 12; ++y)
+			for (int x = 2; x < 12; ++x)
+				CHECK(hits[y][x] == 1);
+	}
+
+	SUBCASE("both windings")
+	{
+		math::V2 a = {3.25f, 40.5f}, b = {30.5f, 33.0f}, c = {17.75f, 60.125f};
+		_triangle_hits(a, b, c, hits);
+		auto count = _hits_count(hits);
+		_triangle_hits(a, c, b, hits);
+
+		CHECK(count > 0);
+		CHECK(_hits_count(hits) == count * 2);
+		CHECK(_hits_max(hits) == 2);
+	}
+
+	SUBCASE("fan around a pixel center")
+	{
+		// the outer vertices sit on the 1/16 grid so the snapped fan is exactly the polygon
+		math::V2 center = {32.5f, 32.5f};
+		math::V2 outer[] = {
+			{52.5f, 32.5f}, {46.25f, 46.0f}, {32.5f, 52.5f}, {19.0f, 46.5f},
+			{12.5f, 32.5f}, {18.5f, 18.5f}, {32.5f, 12.5f}, {47.0625f, 17.9375f},
+		};
+		constexpr int COUNT = sizeof(outer) / sizeof(outer[0]);
+		for (int i = 0; i < COUNT; ++i)
+			_triangle_hits(center, outer[i], outer[(i + 1) % COUNT], hits);
+
+		CHECK(_hits_max(hits) == 1);
+
+		// pixels strictly inside the polygon are covered by exactly one triangle of the fan
+		for (int y = 0; y < HEIGHT; ++y)
+		{
+			for (int x = 0; x < WIDTH; ++x)
+			{
+				auto px = x + 0.5, py = y + 0.5;
+				bool inside = true;
+				for (int i = 0; i < COUNT; ++i)
+				{
+					auto a = outer[i], b = outer[(i + 1) % COUNT];
+					auto cross = (double)(b.x - a.x) * (py - a.y) - (double)(b.y - a.y) * (px - a.x);
+					inside = inside && cross > 0.0;
+				}
+				if (inside)
+					CHECK(hits[y][x] == 1);
+			}
+		}
+	}
+
+	SUBCASE("jittered grid")
+	{
+		// every cell split in two, the vertices are moved around their grid point so edges land on
+		// arbitrary subpixel positions
+		constexpr int CELLS = 8;
+		constexpr float CELL = 7.0f;
+		math::V2 grid[CELLS + 1][CELLS + 1];
+		rc::u32 state = 2463534242u;
+		for (int j = 0; j <= CELLS; ++j)
+		{
+			for (int i = 0; i <= CELLS; ++i)
+			{
+				float jitter[2];
+				for (auto& v: jitter)
+				{
+					state ^= state << 13;
+					state ^= state >> 17;
+					state ^= state << 5;
+					v = ((float)(state % 1000) / 1000.0f - 0.5f) * 3.0f;
+				}
+				grid[j][i] = {4.0f + i * CELL + jitter[0], 4.0f + j * CELL + jitter[1]};
+			}
+		}
+
+		for (int j = 0; j < CELLS; ++j)
+		{
+			for (int i = 0; i < CELLS; ++i)
+			{
+				_triangle_hits(grid[j][i], grid[j][i + 1], grid[j + 1][i + 1], hits);
+				_triangle_hits(grid[j][i], grid[j + 1][i + 1], grid[j + 1][i], hits);
+			}
+		}
+
+		CHECK(_hits_max(hits) == 1);
+
+		// the jitter moves the outer vertices by at most 1.5 pixels, everything inside of that is covered
+		for (int y = 6; y < 4 + CELLS * (int)CELL - 2; ++y)
+			for (int x = 6; x < 4 + CELLS * (int)CELL - 2; ++x)
+				CHECK(hits[y][x] == 1);
+	}
+}
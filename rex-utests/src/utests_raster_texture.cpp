@@ -0,0 +1,111 @@
+#include <rex-raster/texture.h>
+
+#include <rex-core/defer.h>
+
+#include "doctest.h"
+
+#include <string.h>
+
+using namespace rex;
+using namespace rex::raster;
+
+inline static rc::u32
+_random(rc::u32& state)
+{
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+TEST_CASE("[rex-raster]: texture layouts")
+{
+	// sizes that aren't multiples of the tile so the tiled levels are padded, one power of two and a
+	// column that keeps its width down the chain
+	struct Size
+	{
+		int width, height;
+	};
+	Size sizes[] = {{37, 23}, {5, 3}, {1, 7}, {16, 16}};
+
+	Sampler samplers[] = {
+		{TEXTURE_FILTER_NEAREST, TEXTURE_WRAP_REPEAT},
+		{TEXTURE_FILTER_NEAREST, TEXTURE_WRAP_CLAMP},
+		{TEXTURE_FILTER_BILINEAR, TEXTURE_WRAP_REPEAT},
+		{TEXTURE_FILTER_BILINEAR, TEXTURE_WRAP_CLAMP},
+		{TEXTURE_FILTER_TRILINEAR, TEXTURE_WRAP_REPEAT},
+		{TEXTURE_FILTER_TRILINEAR, TEXTURE_WRAP_CLAMP},
+	};
+
+	for (auto size: sizes)
+	{
+		CAPTURE(size.width);
+		CAPTURE(size.height);
+
+		// random colors and alphas so the premultiply and the box filter see every kind of texel
+		auto data = rc::vec_init<rc::u8>();
+		rex_defer(rc::vec_deinit(data));
+		rc::vec_resize(data, (rc::sz)size.width * size.height * 4);
+		rc::u32 state = 2463534242u;
+		for (rc::sz i = 0; i < data.count; ++i)
+			data[i] = (rc::u8)_random(state);
+
+		auto linear = texture_from_rgba8(data.ptr, size.width, size.height, TEXTURE_LAYOUT_LINEAR);
+		rex_defer(texture_deinit(linear));
+		auto tiled = texture_from_rgba8(data.ptr, size.width, size.height, TEXTURE_LAYOUT_TILED);
+		rex_defer(texture_deinit(tiled));
+
+		REQUIRE(linear.levels_count == tiled.levels_count);
+		for (int i = 0; i < linear.levels_count; ++i)
+		{
+			CAPTURE(i);
+			auto& a = linear.levels[i];
+			auto& b = tiled.levels[i];
+			REQUIRE(a.width == b.width);
+			REQUIRE(a.height == b.height);
+
+			int mismatches = 0;
+			for (int y = 0; y < a.height; ++y)
+			{
+				for (int x = 0; x < a.width; ++x)
+				{
+					auto ta = a.texels[texture_index(a, TEXTURE_LAYOUT_LINEAR, x, y)];
+					auto tb = b.texels[texture_index(b, TEXTURE_LAYOUT_TILED, x, y)];
+					mismatches += ::memcmp(&ta, &tb, sizeof(Texel)) != 0;
+				}
+			}
+			CHECK(mismatches == 0);
+		}
+
+		// every mip level, between levels and past the last one, with uvs in and around [0, 1] that land on
+		// texel centers, edges and everything in between
+		for (auto sampler: samplers)
+		{
+			CAPTURE(sampler.filter);
+			CAPTURE(sampler.wrap);
+			for (int step = 0; step <= linear.levels_count * 4; ++step)
+			{
+				auto lod = (float)step * 0.25f;
+				CAPTURE(lod);
+				auto sampling_linear = texture_sampling(linear, sampler, lod);
+				auto sampling_tiled = texture_sampling(tiled, sampler, lod);
+				REQUIRE(sampling_linear.layout == TEXTURE_LAYOUT_LINEAR);
+				REQUIRE(sampling_tiled.layout == TEXTURE_LAYOUT_TILED);
+
+				int mismatches = 0;
+				for (int j = 0; j <= 97; ++j)
+				{
+					for (int i = 0; i <= 97; ++i)
+					{
+						auto u = -1.5f + (float)i * (4.0f / 97.0f);
+						auto v = -1.5f + (float)j * (4.0f / 97.0f);
+						auto a = texture_sample(sampling_linear, u, v);
+						auto b = texture_sample(sampling_tiled, u, v);
+						mismatches += ::memcmp(&a, &b, sizeof(a)) != 0;
+					}
+				}
+				CHECK(mismatches == 0);
+			}
+		}
+	}
+}
@@ -4,12 +4,34 @@
 #include <rex-core/memory.h>
 #include <rex-core/str.h>
 #include <rex-core/time.h>
+#include <rex-core/path.h>
+#include <rex-core/profile.h>
 
 #if REX_OS_WASM
 # include <emscripten/emscripten.h>
 # include <emscripten/html5.h>
 #endif
 
+// screen memory owned by the viewer, used when the window has no back buffer to render into. it is
+// allocated on first use and only reallocated when the window size changes
+static struct
+{
+	Rex_Pixel* pixels;
+	rc::i32 width, height;
+} _screen;
+
+inline static void
+_screen_resize(rc::i32 width, rc::i32 height)
+{
+	if (width == _screen.width && height == _screen.height)
+		return;
+
+	rex_dealloc(_screen.pixels);
+	_screen.pixels = width > 0 && height > 0 ? rex_alloc_N(Rex_Pixel, width * height) : nullptr;
+	_screen.width = width;
+	_screen.height = height;
+}
+
 inline static REX_KEY
 _rc_mouse_button_to_rex_key(rc::MOUSE_BUTTON button)
 {
@@ -79,8 +101,16 @@ _rex_loop(rc::Window* window)
 	rex->screen_width = window->width;
 	rex->screen_height = window->height;
 
-	rex_dealloc(rex->screen);
-	rex->screen = rex_alloc_N(Rex_Pixel, rex->screen_width * rex->screen_height);
+	// render straight into the window presentation buffer when there is one so the blit doesn't copy
+	if (auto back_buffer = rc::window_back_buffer(window, window->width, window->height))
+	{
+		rex->screen = (Rex_Pixel*)back_buffer;
+	}
+	else
+	{
+		_screen_resize(window->width, window->height);
+		rex->screen = _screen.pixels;
+	}
 
 	rex->loop(rex);
 	rc::window_blit(window, (uint32_t*)rex->screen, rex->screen_width, rex->screen_height);
@@ -134,6 +164,14 @@ _rex_event(rc::Window* window, rc::Event event)
 			break;
 		case rc::EVENT_TYPE_KEY_PRESS:
 		{
+			// P starts profiling, pressing it again writes the recorded frames next to the executable
+			if (event.key_press.key == rc::KEY_P)
+			{
+				if (rc::profile_enabled())
+					rc::profile_dump_chrome_trace(rc::str_fmt(rc::frame_allocator(), "%s/rex-trace.json", rc::app_directory()).ptr);
+				rc::profile_enable(rc::profile_enabled() == false);
+			}
+
 			auto key = _rc_key_to_rex_key(event.key_press.key);
 			rex->input.keys[key].down = true;
 			rex->input.keys[key].pressed = true;
@@ -182,6 +220,7 @@ _rex_frame(double, void* user_data)
 	rex->dt = frame_ms * 0.001f;
 	_rex_loop(window);
 	rc::frame_allocator()->clear();
+	rc::profile_frame_mark();
 
 	for (int i = 0; i < REX_KEY_COUNT; ++i)
 	{
@@ -217,7 +256,7 @@ int main()
 	while (_rex_frame(0, window));
 
 	// free resources
-	rex_dealloc(rex->screen);
+	rex_dealloc(_screen.pixels);
 	rc::window_deinit(window);
 	rex->deinit(rex);
 #endif